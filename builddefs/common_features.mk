@@ -44,6 +44,16 @@ else ifeq ($(strip $(DEBUG_MATRIX_SCAN_RATE_ENABLE)), api)
     OPT_DEFS += -DDEBUG_MATRIX_SCAN_RATE
 endif
 
+TASK_PROFILING_ENABLE ?= no
+ifeq ($(strip $(TASK_PROFILING_ENABLE)), yes)
+    ifeq ($(PLATFORM),ARM_ATSAM)
+        $(call CATASTROPHIC_ERROR,Invalid TASK_PROFILING_ENABLE,Task profiling is not supported on arm_atsam)
+    endif
+    OPT_DEFS += -DTASK_PROFILING_ENABLE
+    QUANTUM_SRC += $(QUANTUM_DIR)/task_profiling.c
+    CYCLE_COUNTER_REQUIRED = yes
+endif
+
 AUDIO_ENABLE ?= no
 ifeq ($(strip $(AUDIO_ENABLE)), yes)
     ifeq ($(PLATFORM),CHIBIOS)
@@ -355,6 +365,7 @@ ifeq ($(strip $(LED_MATRIX_ENABLE)), yes)
     POST_CONFIG_H += $(QUANTUM_DIR)/led_matrix/post_config.h
     SRC += $(QUANTUM_DIR)/process_keycode/process_led_matrix.c
     SRC += $(QUANTUM_DIR)/led_matrix/led_matrix.c
+    CYCLE_COUNTER_OPTIONAL = yes
     SRC += $(QUANTUM_DIR)/led_matrix/led_matrix_drivers.c
     LIB8TION_ENABLE := yes
     CIE1931_CURVE := yes
@@ -433,7 +444,7 @@ ifeq ($(strip $(LED_MATRIX_ENABLE)), yes)
 
     ifeq ($(strip $(LED_MATRIX_DRIVER)), snled27351)
         I2C_DRIVER_REQUIRED = yes
-        COMMON_VPATH += $(DRIVER_PATH)/led
+        COMMON_VPATH += $(DRIVER_PATH)/led $(DRIVER_PATH)/led/issi
         SRC += snled27351-mono.c
     endif
 
@@ -463,6 +474,7 @@ ifeq ($(strip $(RGB_MATRIX_ENABLE)), yes)
     POST_CONFIG_H += $(QUANTUM_DIR)/rgb_matrix/post_config.h
     SRC += $(QUANTUM_DIR)/color.c
     SRC += $(QUANTUM_DIR)/rgb_matrix/rgb_matrix.c
+    CYCLE_COUNTER_OPTIONAL = yes
     SRC += $(QUANTUM_DIR)/rgb_matrix/rgb_matrix_drivers.c
     LIB8TION_ENABLE := yes
     CIE1931_CURVE := yes
@@ -548,7 +560,7 @@ ifeq ($(strip $(RGB_MATRIX_ENABLE)), yes)
 
     ifeq ($(strip $(RGB_MATRIX_DRIVER)), snled27351)
         I2C_DRIVER_REQUIRED = yes
-        COMMON_VPATH += $(DRIVER_PATH)/led
+        COMMON_VPATH += $(DRIVER_PATH)/led $(DRIVER_PATH)/led/issi
         SRC += snled27351.c
     endif
 
@@ -632,7 +644,7 @@ ifeq ($(strip $(VIA_ENABLE)), yes)
     TRI_LAYER_ENABLE := yes
 endif
 
-VALID_CUSTOM_MATRIX_TYPES:= yes lite no
+VALID_CUSTOM_MATRIX_TYPES:= yes lite dma no
 
 CUSTOM_MATRIX ?= no
 ifneq ($(strip $(CUSTOM_MATRIX)), yes)
@@ -643,8 +655,15 @@ ifneq ($(strip $(CUSTOM_MATRIX)), yes)
     # Include common stuff for all non custom matrix users
     QUANTUM_SRC += $(QUANTUM_DIR)/matrix_common.c
 
-    # if 'lite' then skip the actual matrix implementation
-    ifneq ($(strip $(CUSTOM_MATRIX)), lite)
+    ifeq ($(strip $(CUSTOM_MATRIX)), dma)
+        # DMA driven scanning plugs in through the 'lite' API
+        ifneq ($(PLATFORM),CHIBIOS)
+            $(call CATASTROPHIC_ERROR,Invalid CUSTOM_MATRIX,CUSTOM_MATRIX="dma" is only supported on ChibiOS)
+        endif
+        OPT_DEFS += -DMATRIX_DMA_ENABLE
+        SRC += $(PLATFORM_PATH)/$(PLATFORM_KEY)/$(DRIVER_DIR)/matrix_dma.c
+    else ifneq ($(strip $(CUSTOM_MATRIX)), lite)
+        # if 'lite' then skip the actual matrix implementation
         # Include the standard or split matrix code if needed
         QUANTUM_SRC += $(QUANTUM_DIR)/matrix.c
     endif
@@ -681,6 +700,7 @@ ifeq ($(strip $(SPLIT_KEYBOARD)), yes)
 
         # Functions added via QUANTUM_LIB_SRC are only included in the final binary if they're called.
         # Unused functions are pruned away, which is why we can add multiple drivers here without bloat.
+        QUANTUM_LIB_SRC += split_delta.c
         ifeq ($(PLATFORM),AVR)
             ifneq ($(NO_I2C),yes)
                 QUANTUM_LIB_SRC += i2c_master.c \
@@ -956,6 +976,17 @@ ifeq ($(strip $(APA102_DRIVER_REQUIRED)), yes)
     SRC += apa102.c
 endif
 
+ifeq ($(strip $(CYCLE_COUNTER_REQUIRED)), yes)
+    ifneq ($(PLATFORM),ARM_ATSAM)
+        SRC += $(PLATFORM_PATH)/$(PLATFORM_KEY)/cycle_counter.c
+    endif
+else ifeq ($(strip $(CYCLE_COUNTER_OPTIONAL)), yes)
+    # Only linked in when used, such as by RGB_MATRIX_RENDER_BUDGET_US or LED_MATRIX_RENDER_BUDGET_US
+    ifneq ($(PLATFORM),ARM_ATSAM)
+        QUANTUM_LIB_SRC += cycle_counter.c
+    endif
+endif
+
 ifeq ($(strip $(ANALOG_DRIVER_REQUIRED)), yes)
     OPT_DEFS += -DHAL_USE_ADC=TRUE
     QUANTUM_LIB_SRC += analog.c
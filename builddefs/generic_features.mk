@@ -34,6 +34,7 @@ GENERIC_FEATURES = \
     DYNAMIC_TAPPING_TERM \
     GRAVE_ESC \
     HAPTIC \
+    KEY_EVENT_QUEUE \
     KEY_LOCK \
     KEY_OVERRIDE \
     LEADER \
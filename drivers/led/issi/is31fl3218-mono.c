@@ -16,6 +16,7 @@
 
 #include "is31fl3218-mono.h"
 #include "i2c_master.h"
+#include "pwm_dirty.h"
 #include "gpio.h"
 
 #define IS31FL3218_PWM_REGISTER_COUNT 18
@@ -30,22 +31,24 @@
 #endif
 
 typedef struct is31fl3218_driver_t {
-    uint8_t pwm_buffer[IS31FL3218_PWM_REGISTER_COUNT];
-    bool    pwm_buffer_dirty;
-    uint8_t led_control_buffer[IS31FL3218_LED_CONTROL_REGISTER_COUNT];
-    bool    led_control_buffer_dirty;
+    uint8_t     pwm_buffer[IS31FL3218_PWM_REGISTER_COUNT];
+    pwm_dirty_t pwm_buffer_dirty;
+    uint8_t     led_control_buffer[IS31FL3218_LED_CONTROL_REGISTER_COUNT];
+    bool        led_control_buffer_dirty;
 } PACKED is31fl3218_driver_t;
 
 // IS31FL3218 has 18 PWM outputs and a fixed I2C address, so no chaining.
 is31fl3218_driver_t driver_buffers = {
     .pwm_buffer               = {0},
-    .pwm_buffer_dirty         = false,
+    .pwm_buffer_dirty         = 0,
     .led_control_buffer       = {0},
     .led_control_buffer_dirty = false,
 };
 
 void is31fl3218_write_register(uint8_t reg, uint8_t data) {
-#if IS31FL3218_I2C_PERSISTENCE > 0
+#if defined(I2C_QUEUE_ENABLE)
+    i2c_queue_write_register(IS31FL3218_I2C_ADDRESS << 1, reg, &data, 1, IS31FL3218_I2C_TIMEOUT);
+#elif IS31FL3218_I2C_PERSISTENCE > 0
     for (uint8_t i = 0; i < IS31FL3218_I2C_PERSISTENCE; i++) {
         if (i2c_write_register(IS31FL3218_I2C_ADDRESS << 1, reg, &data, 1, IS31FL3218_I2C_TIMEOUT) == I2C_STATUS_SUCCESS) break;
     }
@@ -55,13 +58,25 @@ void is31fl3218_write_register(uint8_t reg, uint8_t data) {
 }
 
 void is31fl3218_write_pwm_buffer(void) {
-#if IS31FL3218_I2C_PERSISTENCE > 0
-    for (uint8_t i = 0; i < IS31FL3218_I2C_PERSISTENCE; i++) {
-        if (i2c_write_register(IS31FL3218_I2C_ADDRESS << 1, IS31FL3218_REG_PWM, driver_buffers.pwm_buffer, 18, IS31FL3218_I2C_TIMEOUT) == I2C_STATUS_SUCCESS) break;
-    }
+    // Transmit the dirty PWM register ranges in transfers of up to 18 bytes.
+    pwm_dirty_t dirty = driver_buffers.pwm_buffer_dirty;
+    uint8_t     start, end;
+
+    driver_buffers.pwm_buffer_dirty = 0;
+    while (pwm_dirty_next_range(&dirty, IS31FL3218_PWM_REGISTER_COUNT, &start, &end)) {
+        for (uint8_t i = start; i < end; i += 18) {
+            uint8_t length = MIN(end - i, 18);
+#if defined(I2C_QUEUE_ENABLE)
+            i2c_queue_write_register(IS31FL3218_I2C_ADDRESS << 1, IS31FL3218_REG_PWM + i, driver_buffers.pwm_buffer + i, length, IS31FL3218_I2C_TIMEOUT);
+#elif IS31FL3218_I2C_PERSISTENCE > 0
+            for (uint8_t j = 0; j < IS31FL3218_I2C_PERSISTENCE; j++) {
+                if (i2c_write_register(IS31FL3218_I2C_ADDRESS << 1, IS31FL3218_REG_PWM + i, driver_buffers.pwm_buffer + i, length, IS31FL3218_I2C_TIMEOUT) == I2C_STATUS_SUCCESS) break;
+            }
 #else
-    i2c_write_register(IS31FL3218_I2C_ADDRESS << 1, IS31FL3218_REG_PWM, driver_buffers.pwm_buffer, 18, IS31FL3218_I2C_TIMEOUT);
+            i2c_write_register(IS31FL3218_I2C_ADDRESS << 1, IS31FL3218_REG_PWM + i, driver_buffers.pwm_buffer + i, length, IS31FL3218_I2C_TIMEOUT);
 #endif
+        }
+    }
 }
 
 void is31fl3218_init(void) {
@@ -109,7 +124,7 @@ void is31fl3218_set_value(int index, uint8_t value) {
         }
 
         driver_buffers.pwm_buffer[led.v] = value;
-        driver_buffers.pwm_buffer_dirty  = true;
+        driver_buffers.pwm_buffer_dirty |= pwm_dirty_bit(led.v);
     }
 }
 
@@ -140,8 +155,6 @@ void is31fl3218_update_pwm_buffers(void) {
         is31fl3218_write_pwm_buffer();
         // Load PWM registers and LED Control register data
         is31fl3218_write_register(IS31FL3218_REG_UPDATE, 0x01);
-
-        driver_buffers.pwm_buffer_dirty = false;
     }
 }
 
@@ -3,6 +3,7 @@
 
 #include "is31fl3236-mono.h"
 #include "i2c_master.h"
+#include "pwm_dirty.h"
 #include "gpio.h"
 
 #define IS31FL3236_PWM_REGISTER_COUNT 36
@@ -34,21 +35,23 @@ const uint8_t i2c_addresses[IS31FL3236_DRIVER_COUNT] = {
 };
 
 typedef struct is31fl3236_driver_t {
-    uint8_t pwm_buffer[IS31FL3236_PWM_REGISTER_COUNT];
-    bool    pwm_buffer_dirty;
-    uint8_t led_control_buffer[IS31FL3236_LED_CONTROL_REGISTER_COUNT];
-    bool    led_control_buffer_dirty;
+    uint8_t     pwm_buffer[IS31FL3236_PWM_REGISTER_COUNT];
+    pwm_dirty_t pwm_buffer_dirty;
+    uint8_t     led_control_buffer[IS31FL3236_LED_CONTROL_REGISTER_COUNT];
+    bool        led_control_buffer_dirty;
 } PACKED is31fl3236_driver_t;
 
 is31fl3236_driver_t driver_buffers[IS31FL3236_DRIVER_COUNT] = {{
     .pwm_buffer               = {0},
-    .pwm_buffer_dirty         = false,
+    .pwm_buffer_dirty         = 0,
     .led_control_buffer       = {0},
     .led_control_buffer_dirty = false,
 }};
 
 void is31fl3236_write_register(uint8_t index, uint8_t reg, uint8_t data) {
-#if IS31FL3236_I2C_PERSISTENCE > 0
+#if defined(I2C_QUEUE_ENABLE)
+    i2c_queue_write_register(i2c_addresses[index] << 1, reg, &data, 1, IS31FL3236_I2C_TIMEOUT);
+#elif IS31FL3236_I2C_PERSISTENCE > 0
     for (uint8_t i = 0; i < IS31FL3236_I2C_PERSISTENCE; i++) {
         if (i2c_write_register(i2c_addresses[index] << 1, reg, &data, 1, IS31FL3236_I2C_TIMEOUT) == I2C_STATUS_SUCCESS) break;
     }
@@ -58,13 +61,25 @@ void is31fl3236_write_register(uint8_t index, uint8_t reg, uint8_t data) {
 }
 
 void is31fl3236_write_pwm_buffer(uint8_t index) {
-#if IS31FL3236_I2C_PERSISTENCE > 0
-    for (uint8_t i = 0; i < IS31FL3236_I2C_PERSISTENCE; i++) {
-        if (i2c_write_register(i2c_addresses[index] << 1, IS31FL3236_REG_PWM, driver_buffers[index].pwm_buffer, 36, IS31FL3236_I2C_TIMEOUT) == I2C_STATUS_SUCCESS) break;
-    }
+    // Transmit the dirty PWM register ranges in transfers of up to 36 bytes.
+    pwm_dirty_t dirty = driver_buffers[index].pwm_buffer_dirty;
+    uint8_t     start, end;
+
+    driver_buffers[index].pwm_buffer_dirty = 0;
+    while (pwm_dirty_next_range(&dirty, IS31FL3236_PWM_REGISTER_COUNT, &start, &end)) {
+        for (uint8_t i = start; i < end; i += 36) {
+            uint8_t length = MIN(end - i, 36);
+#if defined(I2C_QUEUE_ENABLE)
+            i2c_queue_write_register(i2c_addresses[index] << 1, IS31FL3236_REG_PWM + i, driver_buffers[index].pwm_buffer + i, length, IS31FL3236_I2C_TIMEOUT);
+#elif IS31FL3236_I2C_PERSISTENCE > 0
+            for (uint8_t j = 0; j < IS31FL3236_I2C_PERSISTENCE; j++) {
+                if (i2c_write_register(i2c_addresses[index] << 1, IS31FL3236_REG_PWM + i, driver_buffers[index].pwm_buffer + i, length, IS31FL3236_I2C_TIMEOUT) == I2C_STATUS_SUCCESS) break;
+            }
 #else
-    i2c_write_register(i2c_addresses[index] << 1, IS31FL3236_REG_PWM, driver_buffers[index].pwm_buffer, 36, IS31FL3236_I2C_TIMEOUT);
+            i2c_write_register(i2c_addresses[index] << 1, IS31FL3236_REG_PWM + i, driver_buffers[index].pwm_buffer + i, length, IS31FL3236_I2C_TIMEOUT);
 #endif
+        }
+    }
 }
 
 void is31fl3236_init_drivers(void) {
@@ -123,7 +138,7 @@ void is31fl3236_set_value(int index, uint8_t value) {
         }
 
         driver_buffers[led.driver].pwm_buffer[led.v] = value;
-        driver_buffers[led.driver].pwm_buffer_dirty  = true;
+        driver_buffers[led.driver].pwm_buffer_dirty |= pwm_dirty_bit(led.v);
     }
 }
 
@@ -146,8 +161,6 @@ void is31fl3236_update_pwm_buffers(uint8_t index) {
         is31fl3236_write_pwm_buffer(index);
         // Load PWM registers and LED Control register data
         is31fl3236_write_register(index, IS31FL3236_REG_UPDATE, 0x01);
-
-        driver_buffers[index].pwm_buffer_dirty = false;
     }
 }
 
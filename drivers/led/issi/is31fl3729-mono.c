@@ -18,6 +18,7 @@
 
 #include "is31fl3729-mono.h"
 #include "i2c_master.h"
+#include "pwm_dirty.h"
 #include "gpio.h"
 #include "wait.h"
 
@@ -80,21 +81,23 @@ const uint8_t i2c_addresses[IS31FL3729_DRIVER_COUNT] = {
 // These buffers match the PWM & scaling registers.
 // Storing them like this is optimal for I2C transfers to the registers.
 typedef struct is31fl3729_driver_t {
-    uint8_t pwm_buffer[IS31FL3729_PWM_REGISTER_COUNT];
-    bool    pwm_buffer_dirty;
-    uint8_t scaling_buffer[IS31FL3729_SCALING_REGISTER_COUNT];
-    bool    scaling_buffer_dirty;
+    uint8_t     pwm_buffer[IS31FL3729_PWM_REGISTER_COUNT];
+    pwm_dirty_t pwm_buffer_dirty;
+    uint8_t     scaling_buffer[IS31FL3729_SCALING_REGISTER_COUNT];
+    bool        scaling_buffer_dirty;
 } PACKED is31fl3729_driver_t;
 
 is31fl3729_driver_t driver_buffers[IS31FL3729_DRIVER_COUNT] = {{
     .pwm_buffer           = {0},
-    .pwm_buffer_dirty     = false,
+    .pwm_buffer_dirty     = 0,
     .scaling_buffer       = {0},
     .scaling_buffer_dirty = false,
 }};
 
 void is31fl3729_write_register(uint8_t index, uint8_t reg, uint8_t data) {
-#if IS31FL3729_I2C_PERSISTENCE > 0
+#if defined(I2C_QUEUE_ENABLE)
+    i2c_queue_write_register(i2c_addresses[index] << 1, reg, &data, 1, IS31FL3729_I2C_TIMEOUT);
+#elif IS31FL3729_I2C_PERSISTENCE > 0
     for (uint8_t i = 0; i < IS31FL3729_I2C_PERSISTENCE; i++) {
         if (i2c_write_register(i2c_addresses[index] << 1, reg, &data, 1, IS31FL3729_I2C_TIMEOUT) == I2C_STATUS_SUCCESS) break;
     }
@@ -104,17 +107,24 @@ void is31fl3729_write_register(uint8_t index, uint8_t reg, uint8_t data) {
 }
 
 void is31fl3729_write_pwm_buffer(uint8_t index) {
-    // Transmit PWM registers in 11 transfers of 13 bytes.
-
-    // Iterate over the pwm_buffer contents at 13 byte intervals.
-    for (uint8_t i = 0; i <= IS31FL3729_PWM_REGISTER_COUNT; i += 13) {
-#if IS31FL3729_I2C_PERSISTENCE > 0
-        for (uint8_t j = 0; j < IS31FL3729_I2C_PERSISTENCE; j++) {
-            if (i2c_write_register(i2c_addresses[index] << 1, IS31FL3729_REG_PWM + i, driver_buffers[index].pwm_buffer + i, 13, IS31FL3729_I2C_TIMEOUT) == I2C_STATUS_SUCCESS) break;
-        }
+    // Transmit the dirty PWM register ranges in transfers of up to 13 bytes.
+    pwm_dirty_t dirty = driver_buffers[index].pwm_buffer_dirty;
+    uint8_t     start, end;
+
+    driver_buffers[index].pwm_buffer_dirty = 0;
+    while (pwm_dirty_next_range(&dirty, IS31FL3729_PWM_REGISTER_COUNT, &start, &end)) {
+        for (uint8_t i = start; i < end; i += 13) {
+            uint8_t length = MIN(end - i, 13);
+#if defined(I2C_QUEUE_ENABLE)
+            i2c_queue_write_register(i2c_addresses[index] << 1, IS31FL3729_REG_PWM + i, driver_buffers[index].pwm_buffer + i, length, IS31FL3729_I2C_TIMEOUT);
+#elif IS31FL3729_I2C_PERSISTENCE > 0
+            for (uint8_t j = 0; j < IS31FL3729_I2C_PERSISTENCE; j++) {
+                if (i2c_write_register(i2c_addresses[index] << 1, IS31FL3729_REG_PWM + i, driver_buffers[index].pwm_buffer + i, length, IS31FL3729_I2C_TIMEOUT) == I2C_STATUS_SUCCESS) break;
+            }
 #else
-        i2c_write_register(i2c_addresses[index] << 1, IS31FL3729_REG_PWM + i, driver_buffers[index].pwm_buffer + i, 13, IS31FL3729_I2C_TIMEOUT);
+            i2c_write_register(i2c_addresses[index] << 1, IS31FL3729_REG_PWM + i, driver_buffers[index].pwm_buffer + i, length, IS31FL3729_I2C_TIMEOUT);
 #endif
+        }
     }
 }
 
@@ -165,7 +175,7 @@ void is31fl3729_set_value(int index, uint8_t value) {
         }
 
         driver_buffers[led.driver].pwm_buffer[led.v] = value;
-        driver_buffers[led.driver].pwm_buffer_dirty  = true;
+        driver_buffers[led.driver].pwm_buffer_dirty |= pwm_dirty_bit(led.v);
     }
 }
 
@@ -191,8 +201,6 @@ void is31fl3729_set_scaling_register(uint8_t index, uint8_t value) {
 void is31fl3729_update_pwm_buffers(uint8_t index) {
     if (driver_buffers[index].pwm_buffer_dirty) {
         is31fl3729_write_pwm_buffer(index);
-
-        driver_buffers[index].pwm_buffer_dirty = false;
     }
 }
 
@@ -19,6 +19,7 @@
 
 #include "is31fl3741.h"
 #include "i2c_master.h"
+#include "pwm_dirty.h"
 #include "gpio.h"
 #include "wait.h"
 
@@ -75,25 +76,29 @@ const uint8_t i2c_addresses[IS31FL3741_DRIVER_COUNT] = {
 // buffers and the transfers in is31fl3741_write_pwm_buffer() but it's
 // probably not worth the extra complexity.
 typedef struct is31fl3741_driver_t {
-    uint8_t pwm_buffer_0[IS31FL3741_PWM_0_REGISTER_COUNT];
-    uint8_t pwm_buffer_1[IS31FL3741_PWM_1_REGISTER_COUNT];
-    bool    pwm_buffer_dirty;
-    uint8_t scaling_buffer_0[IS31FL3741_SCALING_0_REGISTER_COUNT];
-    uint8_t scaling_buffer_1[IS31FL3741_SCALING_1_REGISTER_COUNT];
-    bool    scaling_buffer_dirty;
+    uint8_t     pwm_buffer_0[IS31FL3741_PWM_0_REGISTER_COUNT];
+    uint8_t     pwm_buffer_1[IS31FL3741_PWM_1_REGISTER_COUNT];
+    pwm_dirty_t pwm_buffer_0_dirty;
+    pwm_dirty_t pwm_buffer_1_dirty;
+    uint8_t     scaling_buffer_0[IS31FL3741_SCALING_0_REGISTER_COUNT];
+    uint8_t     scaling_buffer_1[IS31FL3741_SCALING_1_REGISTER_COUNT];
+    bool        scaling_buffer_dirty;
 } PACKED is31fl3741_driver_t;
 
 is31fl3741_driver_t driver_buffers[IS31FL3741_DRIVER_COUNT] = {{
     .pwm_buffer_0         = {0},
     .pwm_buffer_1         = {0},
-    .pwm_buffer_dirty     = false,
+    .pwm_buffer_0_dirty   = 0,
+    .pwm_buffer_1_dirty   = 0,
     .scaling_buffer_0     = {0},
     .scaling_buffer_1     = {0},
     .scaling_buffer_dirty = false,
 }};
 
 void is31fl3741_write_register(uint8_t index, uint8_t reg, uint8_t data) {
-#if IS31FL3741_I2C_PERSISTENCE > 0
+#if defined(I2C_QUEUE_ENABLE)
+    i2c_queue_write_register(i2c_addresses[index] << 1, reg, &data, 1, IS31FL3741_I2C_TIMEOUT);
+#elif IS31FL3741_I2C_PERSISTENCE > 0
     for (uint8_t i = 0; i < IS31FL3741_I2C_PERSISTENCE; i++) {
         if (i2c_write_register(i2c_addresses[index] << 1, reg, &data, 1, IS31FL3741_I2C_TIMEOUT) == I2C_STATUS_SUCCESS) break;
     }
@@ -108,34 +113,52 @@ void is31fl3741_select_page(uint8_t index, uint8_t page) {
 }
 
 void is31fl3741_write_pwm_buffer(uint8_t index) {
-    is31fl3741_select_page(index, IS31FL3741_COMMAND_PWM_0);
-
-    // Transmit PWM0 registers in 6 transfers of 30 bytes.
-
-    // Iterate over the pwm_buffer_0 contents at 30 byte intervals.
-    for (uint8_t i = 0; i < IS31FL3741_PWM_0_REGISTER_COUNT; i += 30) {
-#if IS31FL3741_I2C_PERSISTENCE > 0
-        for (uint8_t j = 0; j < IS31FL3741_I2C_PERSISTENCE; j++) {
-            if (i2c_write_register(i2c_addresses[index] << 1, i, driver_buffers[index].pwm_buffer_0 + i, 30, IS31FL3741_I2C_TIMEOUT) == I2C_STATUS_SUCCESS) break;
-        }
+    uint8_t start, end;
+
+    if (driver_buffers[index].pwm_buffer_0_dirty) {
+        pwm_dirty_t dirty = driver_buffers[index].pwm_buffer_0_dirty;
+
+        driver_buffers[index].pwm_buffer_0_dirty = 0;
+        is31fl3741_select_page(index, IS31FL3741_COMMAND_PWM_0);
+
+        // Transmit the dirty PWM0 register ranges in transfers of up to 30 bytes.
+        while (pwm_dirty_next_range(&dirty, IS31FL3741_PWM_0_REGISTER_COUNT, &start, &end)) {
+            for (uint8_t i = start; i < end; i += 30) {
+                uint8_t length = MIN(end - i, 30);
+#if defined(I2C_QUEUE_ENABLE)
+                i2c_queue_write_register(i2c_addresses[index] << 1, i, driver_buffers[index].pwm_buffer_0 + i, length, IS31FL3741_I2C_TIMEOUT);
+#elif IS31FL3741_I2C_PERSISTENCE > 0
+                for (uint8_t j = 0; j < IS31FL3741_I2C_PERSISTENCE; j++) {
+                    if (i2c_write_register(i2c_addresses[index] << 1, i, driver_buffers[index].pwm_buffer_0 + i, length, IS31FL3741_I2C_TIMEOUT) == I2C_STATUS_SUCCESS) break;
+                }
 #else
-        i2c_write_register(i2c_addresses[index] << 1, i, driver_buffers[index].pwm_buffer_0 + i, 30, IS31FL3741_I2C_TIMEOUT);
+                i2c_write_register(i2c_addresses[index] << 1, i, driver_buffers[index].pwm_buffer_0 + i, length, IS31FL3741_I2C_TIMEOUT);
 #endif
+            }
+        }
     }
 
-    is31fl3741_select_page(index, IS31FL3741_COMMAND_PWM_1);
-
-    // Transmit PWM1 registers in 9 transfers of 19 bytes.
-
-    // Iterate over the pwm_buffer_1 contents at 19 byte intervals.
-    for (uint8_t i = 0; i < IS31FL3741_PWM_1_REGISTER_COUNT; i += 19) {
-#if IS31FL3741_I2C_PERSISTENCE > 0
-        for (uint8_t i = 0; i < IS31FL3741_I2C_PERSISTENCE; i++) {
-            if (i2c_write_register(i2c_addresses[index] << 1, i, driver_buffers[index].pwm_buffer_1 + i, 19, IS31FL3741_I2C_TIMEOUT) == I2C_STATUS_SUCCESS) break;
-        }
+    if (driver_buffers[index].pwm_buffer_1_dirty) {
+        pwm_dirty_t dirty = driver_buffers[index].pwm_buffer_1_dirty;
+
+        driver_buffers[index].pwm_buffer_1_dirty = 0;
+        is31fl3741_select_page(index, IS31FL3741_COMMAND_PWM_1);
+
+        // Transmit the dirty PWM1 register ranges in transfers of up to 19 bytes.
+        while (pwm_dirty_next_range(&dirty, IS31FL3741_PWM_1_REGISTER_COUNT, &start, &end)) {
+            for (uint8_t i = start; i < end; i += 19) {
+                uint8_t length = MIN(end - i, 19);
+#if defined(I2C_QUEUE_ENABLE)
+                i2c_queue_write_register(i2c_addresses[index] << 1, i, driver_buffers[index].pwm_buffer_1 + i, length, IS31FL3741_I2C_TIMEOUT);
+#elif IS31FL3741_I2C_PERSISTENCE > 0
+                for (uint8_t j = 0; j < IS31FL3741_I2C_PERSISTENCE; j++) {
+                    if (i2c_write_register(i2c_addresses[index] << 1, i, driver_buffers[index].pwm_buffer_1 + i, length, IS31FL3741_I2C_TIMEOUT) == I2C_STATUS_SUCCESS) break;
+                }
 #else
-        i2c_write_register(i2c_addresses[index] << 1, i, driver_buffers[index].pwm_buffer_1 + i, 19, IS31FL3741_I2C_TIMEOUT);
+                i2c_write_register(i2c_addresses[index] << 1, i, driver_buffers[index].pwm_buffer_1 + i, length, IS31FL3741_I2C_TIMEOUT);
 #endif
+            }
+        }
     }
 }
 
@@ -196,8 +219,10 @@ uint8_t get_pwm_value(uint8_t driver, uint16_t reg) {
 void set_pwm_value(uint8_t driver, uint16_t reg, uint8_t value) {
     if (reg & 0x100) {
         driver_buffers[driver].pwm_buffer_1[reg & 0xFF] = value;
+        driver_buffers[driver].pwm_buffer_1_dirty |= pwm_dirty_bit(reg & 0xFF);
     } else {
         driver_buffers[driver].pwm_buffer_0[reg] = value;
+        driver_buffers[driver].pwm_buffer_0_dirty |= pwm_dirty_bit(reg);
     }
 }
 
@@ -214,7 +239,6 @@ void is31fl3741_set_color(int index, uint8_t red, uint8_t green, uint8_t blue) {
         set_pwm_value(led.driver, led.r, red);
         set_pwm_value(led.driver, led.g, green);
         set_pwm_value(led.driver, led.b, blue);
-        driver_buffers[led.driver].pwm_buffer_dirty = true;
     }
 }
 
@@ -244,10 +268,8 @@ void is31fl3741_set_led_control_register(uint8_t index, bool red, bool green, bo
 }
 
 void is31fl3741_update_pwm_buffers(uint8_t index) {
-    if (driver_buffers[index].pwm_buffer_dirty) {
+    if (driver_buffers[index].pwm_buffer_0_dirty || driver_buffers[index].pwm_buffer_1_dirty) {
         is31fl3741_write_pwm_buffer(index);
-
-        driver_buffers[index].pwm_buffer_dirty = false;
     }
 }
 
@@ -255,7 +277,6 @@ void is31fl3741_set_pwm_buffer(const is31fl3741_led_t *pled, uint8_t red, uint8_
     set_pwm_value(pled->driver, pled->r, red);
     set_pwm_value(pled->driver, pled->g, green);
     set_pwm_value(pled->driver, pled->b, blue);
-    driver_buffers[pled->driver].pwm_buffer_dirty = true;
 }
 
 void is31fl3741_update_led_control_registers(uint8_t index) {
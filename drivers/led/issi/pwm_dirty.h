@@ -0,0 +1,43 @@
+// Copyright 2024 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "util.h"
+
+// Tracks which parts of a PWM register buffer have changed since it was last
+// transmitted, one bit per block of PWM_DIRTY_BLOCK_SIZE registers, so that
+// flushes only need to send the blocks around the LEDs that were updated.
+#define PWM_DIRTY_BLOCK_SIZE 16
+
+typedef uint16_t pwm_dirty_t;
+
+_Static_assert(sizeof(pwm_dirty_t) * 8 * PWM_DIRTY_BLOCK_SIZE >= 256, "pwm_dirty_t must cover every 8-bit register address");
+
+static inline pwm_dirty_t pwm_dirty_bit(uint8_t reg) {
+    return (pwm_dirty_t)1 << (reg / PWM_DIRTY_BLOCK_SIZE);
+}
+
+// Removes the first run of consecutive dirty blocks, and returns the registers
+// it covers as [start, end), clamped to the size of the buffer.
+static inline bool pwm_dirty_next_range(pwm_dirty_t *dirty, uint8_t count, uint8_t *start, uint8_t *end) {
+    if (!*dirty) {
+        return false;
+    }
+
+    uint8_t block = 0;
+    while (!(*dirty & ((pwm_dirty_t)1 << block))) {
+        block++;
+    }
+    *start = block * PWM_DIRTY_BLOCK_SIZE;
+
+    while (block < sizeof(pwm_dirty_t) * 8 && (*dirty & ((pwm_dirty_t)1 << block))) {
+        *dirty &= ~((pwm_dirty_t)1 << block);
+        block++;
+    }
+    *end = MIN(block * PWM_DIRTY_BLOCK_SIZE, count);
+
+    return *start < *end;
+}
@@ -84,7 +84,7 @@ void ps2_mouse_task(void) {
         mouse_report.x       = ps2_host_recv_response();
         mouse_report.y       = ps2_host_recv_response();
 #    ifdef PS2_MOUSE_ENABLE_SCROLLING
-        mouse_report.v = -(ps2_host_recv_response() & PS2_MOUSE_SCROLL_MASK);
+        mouse_report.v = -(int8_t)(ps2_host_recv_response() & PS2_MOUSE_SCROLL_MASK);
 #    endif
     } else {
         if (debug_mouse) print("ps2_mouse: fail to get mouse packet\n");
@@ -97,7 +97,7 @@ void ps2_mouse_task(void) {
         mouse_report.x       = ps2_host_recv_response();
         mouse_report.y       = ps2_host_recv_response();
 #    ifdef PS2_MOUSE_ENABLE_SCROLLING
-        mouse_report.v       = -(ps2_host_recv_response() & PS2_MOUSE_SCROLL_MASK);
+        mouse_report.v       = -(int8_t)(ps2_host_recv_response() & PS2_MOUSE_SCROLL_MASK);
 #    endif
     } else {
         if (debug_mouse) print("ps2_mouse: fail to get mouse packet\n");
@@ -191,7 +191,7 @@ static inline void ps2_mouse_convert_report_to_hid(report_mouse_t *mouse_report)
     mouse_report->x *= PS2_MOUSE_X_MULTIPLIER;
     mouse_report->y *= PS2_MOUSE_Y_MULTIPLIER;
 #endif
-    mouse_report->v *= PS2_MOUSE_V_MULTIPLIER;
+    mouse_report->v *= PS2_MOUSE_V_MULTIPLIER * MOUSE_WHEEL_DETENT_V;
 
 #ifdef PS2_MOUSE_INVERT_BUTTONS
     // swap left & right buttons
@@ -290,6 +290,8 @@ static inline void ps2_mouse_scroll_button_task(report_mouse_t *mouse_report) {
             mouse_report->h = scroll_x / (PS2_MOUSE_SCROLL_DIVISOR_H);
             scroll_y += (mouse_report->v * (PS2_MOUSE_SCROLL_DIVISOR_V));
             scroll_x -= (mouse_report->h * (PS2_MOUSE_SCROLL_DIVISOR_H));
+            mouse_report->v *= MOUSE_WHEEL_DETENT_V;
+            mouse_report->h *= MOUSE_WHEEL_DETENT_H;
             mouse_report->x = 0;
             mouse_report->y = 0;
 #ifdef PS2_MOUSE_INVERT_H
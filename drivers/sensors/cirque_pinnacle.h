@@ -53,7 +53,11 @@
 #    endif
 #endif
 #if !defined(POINTING_DEVICE_TASK_THROTTLE_MS)
-#    define POINTING_DEVICE_TASK_THROTTLE_MS 10 // Cirque Pinnacle in normal operation produces data every 10ms. Advanced configuration for pen/stylus usage might require lower values.
+#    ifdef POINTING_DEVICE_MOTION_PIN
+#        define POINTING_DEVICE_TASK_THROTTLE_MS 1 // Only read once the data ready pin is set, so samples are read as soon as they are produced.
+#    else
+#        define POINTING_DEVICE_TASK_THROTTLE_MS 10 // Cirque Pinnacle in normal operation produces data every 10ms. Advanced configuration for pen/stylus usage might require lower values.
+#    endif
 #endif
 #if defined(POINTING_DEVICE_DRIVER_cirque_pinnacle_i2c)
 #    include "i2c_master.h"
@@ -94,7 +98,8 @@
 
 // Convenient way to store and access measurements
 typedef struct {
-    bool valid; // true if valid data was read, false if no data was ready
+    bool     valid;     // true if valid data was read, false if no data was ready
+    uint16_t timestamp; // timer value when the data was read
 #if CIRQUE_PINNACLE_POSITION_MODE
     uint16_t xValue;
     uint16_t yValue;
@@ -0,0 +1,39 @@
+// Copyright 2024 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <avr/io.h>
+#include <util/atomic.h>
+#include "timer.h"
+#include "timer_avr.h"
+#include "cycle_counter.h"
+
+#if defined(__AVR_ATmega32A__)
+#    define TIMER_COMPARE_PENDING (TIFR & _BV(OCF0))
+#elif defined(__AVR_ATtiny85__)
+#    define TIMER_COMPARE_PENDING (TIFR & _BV(OCF0A))
+#else
+#    define TIMER_COMPARE_PENDING (TIFR0 & _BV(OCF0A))
+#endif
+
+uint32_t cycle_counter_read(void) {
+    uint32_t ms;
+    uint8_t  raw;
+
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+        ms  = timer_count;
+        raw = TIMER_RAW;
+
+        // The timer may have wrapped since interrupts were disabled, in which
+        // case its tick is still pending. A small raw value was read after the
+        // wrap, while one close to the top was read before it.
+        if (TIMER_COMPARE_PENDING && raw < TIMER_RAW_TOP / 2) {
+            ms++;
+        }
+    }
+
+    return (ms * (TIMER_RAW_TOP + 1) + raw) * TIMER_PRESCALER;
+}
+
+uint32_t cycle_counter_from_us(uint32_t us) {
+    return us * (F_CPU / 1000000);
+}
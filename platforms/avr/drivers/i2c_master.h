@@ -21,6 +21,10 @@
 
 #include <stdint.h>
 
+#ifdef I2C_QUEUE_ENABLE
+#    error "I2C_QUEUE_ENABLE is only supported on ChibiOS"
+#endif
+
 // ### DEPRECATED - DO NOT USE ###
 #define i2c_writeReg(devaddr, regaddr, data, length, timeout) i2c_write_register(devaddr, regaddr, data, length, timeout)
 #define i2c_writeReg16(devaddr, regaddr, data, length, timeout) i2c_write_register16(devaddr, regaddr, data, length, timeout)
@@ -0,0 +1,24 @@
+// Copyright 2024 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <ch.h>
+#include <hal.h>
+#include "chibios_config.h"
+#include "cycle_counter.h"
+
+uint32_t cycle_counter_read(void) {
+#if PORT_SUPPORTS_RT == TRUE
+    return (uint32_t)chSysGetRealtimeCounterX();
+#else
+    // Cortex-M0(+) parts have no DWT cycle counter, fall back to system ticks
+    return (uint32_t)chVTGetSystemTimeX();
+#endif
+}
+
+uint32_t cycle_counter_from_us(uint32_t us) {
+#if PORT_SUPPORTS_RT == TRUE
+    return US2RTC(REALTIME_COUNTER_CLOCK, us);
+#else
+    return TIME_US2I(us);
+#endif
+}
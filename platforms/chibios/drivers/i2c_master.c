@@ -74,6 +74,21 @@
 #    define I2C_DRIVER I2CD1
 #endif
 
+#ifdef I2C_QUEUE_ENABLE
+#    ifndef I2C_QUEUE_SIZE
+#        define I2C_QUEUE_SIZE 32
+#    endif
+#    ifndef I2C_QUEUE_PAYLOAD_SIZE
+#        define I2C_QUEUE_PAYLOAD_SIZE 36
+#    endif
+#    ifndef I2C_QUEUE_THREAD_PRIORITY
+#        define I2C_QUEUE_THREAD_PRIORITY (NORMALPRIO + 1)
+#    endif
+#    ifndef I2C_QUEUE_THREAD_STACK_SIZE
+#        define I2C_QUEUE_THREAD_STACK_SIZE 256
+#    endif
+#endif
+
 #ifdef USE_GPIOV1
 #    ifndef I2C1_SCL_PAL_MODE
 #        define I2C1_SCL_PAL_MODE PAL_MODE_ALTERNATE_OPENDRAIN
@@ -129,6 +144,109 @@ static i2c_status_t i2c_epilogue(const msg_t status) {
     return status == MSG_TIMEOUT ? I2C_STATUS_TIMEOUT : I2C_STATUS_ERROR;
 }
 
+#ifdef I2C_QUEUE_ENABLE
+typedef struct {
+    uint8_t  address;
+    uint8_t  length;
+    uint16_t timeout;
+    uint8_t  packet[I2C_QUEUE_PAYLOAD_SIZE + 1];
+} i2c_queue_job_t;
+
+static i2c_queue_job_t       i2c_queue_jobs[I2C_QUEUE_SIZE];
+static uint8_t               i2c_queue_head    = 0;
+static uint8_t               i2c_queue_tail    = 0;
+static volatile i2c_status_t i2c_queue_status  = I2C_STATUS_SUCCESS;
+static bool                  i2c_queue_started = false;
+static semaphore_t           i2c_queue_free;
+static semaphore_t           i2c_queue_pending;
+static THD_WORKING_AREA(i2c_queue_thread_wa, I2C_QUEUE_THREAD_STACK_SIZE);
+
+/**
+ * @brief Executes queued writes in order. The thread sleeps while ChibiOS
+ * performs each transfer, which lets the main loop carry on in the meantime.
+ */
+static THD_FUNCTION(i2c_queue_thread, arg) {
+    (void)arg;
+    chRegSetThreadName("i2c_queue");
+
+    while (true) {
+        chSemWait(&i2c_queue_pending);
+
+        i2c_queue_job_t* job = &i2c_queue_jobs[i2c_queue_tail];
+        i2cStart(&I2C_DRIVER, &i2cconfig);
+        msg_t        msg    = i2cMasterTransmitTimeout(&I2C_DRIVER, (job->address >> 1), job->packet, job->length + 1, 0, 0, TIME_MS2I(job->timeout));
+        i2c_status_t status = i2c_epilogue(msg);
+        if (status != I2C_STATUS_SUCCESS) {
+            i2c_queue_status = status;
+        }
+
+        i2c_queue_tail = (i2c_queue_tail + 1) % I2C_QUEUE_SIZE;
+        chSemSignal(&i2c_queue_free);
+    }
+}
+
+static void i2c_queue_start(void) {
+    if (!i2c_queue_started) {
+        i2c_queue_started = true;
+
+        chSemObjectInit(&i2c_queue_free, I2C_QUEUE_SIZE);
+        chSemObjectInit(&i2c_queue_pending, 0);
+        chThdCreateStatic(i2c_queue_thread_wa, sizeof(i2c_queue_thread_wa), I2C_QUEUE_THREAD_PRIORITY, i2c_queue_thread, NULL);
+    }
+}
+
+i2c_status_t i2c_queue_write_register(uint8_t devaddr, uint8_t regaddr, const uint8_t* data, uint16_t length, uint16_t timeout) {
+    if (length > I2C_QUEUE_PAYLOAD_SIZE) {
+        return i2c_write_register(devaddr, regaddr, data, length, timeout);
+    }
+
+    i2c_queue_start();
+
+    // Blocks only while the queue is full, until the thread has freed a slot
+    chSemWait(&i2c_queue_free);
+
+    i2c_queue_job_t* job = &i2c_queue_jobs[i2c_queue_head];
+    job->address         = devaddr;
+    job->length          = length;
+    job->timeout         = timeout;
+    job->packet[0]       = regaddr;
+    memcpy(&job->packet[1], data, length);
+
+    i2c_queue_head = (i2c_queue_head + 1) % I2C_QUEUE_SIZE;
+    chSemSignal(&i2c_queue_pending);
+
+    return I2C_STATUS_SUCCESS;
+}
+
+i2c_status_t i2c_queue_wait(void) {
+    if (!i2c_queue_started) {
+        return I2C_STATUS_SUCCESS;
+    }
+
+    // Every slot is free again once the last queued write has completed
+    for (uint8_t i = 0; i < I2C_QUEUE_SIZE; i++) {
+        chSemWait(&i2c_queue_free);
+    }
+    chSemReset(&i2c_queue_free, I2C_QUEUE_SIZE);
+
+    i2c_status_t status = i2c_queue_status;
+    i2c_queue_status    = I2C_STATUS_SUCCESS;
+    return status;
+}
+#endif
+
+/**
+ * @brief Prepares the I2C peripheral for a blocking transaction. When the
+ * write queue is enabled, any queued writes are completed first so that the
+ * bus is free and transactions keep their order.
+ */
+static void i2c_prologue(void) {
+#ifdef I2C_QUEUE_ENABLE
+    i2c_queue_wait();
+#endif
+    i2cStart(&I2C_DRIVER, &i2cconfig);
+}
+
 __attribute__((weak)) void i2c_init(void) {
     static bool is_initialised = false;
     if (!is_initialised) {
@@ -150,19 +268,19 @@ __attribute__((weak)) void i2c_init(void) {
 }
 
 i2c_status_t i2c_transmit(uint8_t address, const uint8_t* data, uint16_t length, uint16_t timeout) {
-    i2cStart(&I2C_DRIVER, &i2cconfig);
+    i2c_prologue();
     msg_t status = i2cMasterTransmitTimeout(&I2C_DRIVER, (address >> 1), data, length, 0, 0, TIME_MS2I(timeout));
     return i2c_epilogue(status);
 }
 
 i2c_status_t i2c_receive(uint8_t address, uint8_t* data, uint16_t length, uint16_t timeout) {
-    i2cStart(&I2C_DRIVER, &i2cconfig);
+    i2c_prologue();
     msg_t status = i2cMasterReceiveTimeout(&I2C_DRIVER, (address >> 1), data, length, TIME_MS2I(timeout));
     return i2c_epilogue(status);
 }
 
 i2c_status_t i2c_write_register(uint8_t devaddr, uint8_t regaddr, const uint8_t* data, uint16_t length, uint16_t timeout) {
-    i2cStart(&I2C_DRIVER, &i2cconfig);
+    i2c_prologue();
 
     uint8_t complete_packet[length + 1];
     for (uint16_t i = 0; i < length; i++) {
@@ -175,7 +293,7 @@ i2c_status_t i2c_write_register(uint8_t devaddr, uint8_t regaddr, const uint8_t*
 }
 
 i2c_status_t i2c_write_register16(uint8_t devaddr, uint16_t regaddr, const uint8_t* data, uint16_t length, uint16_t timeout) {
-    i2cStart(&I2C_DRIVER, &i2cconfig);
+    i2c_prologue();
 
     uint8_t complete_packet[length + 2];
     for (uint16_t i = 0; i < length; i++) {
@@ -189,13 +307,13 @@ i2c_status_t i2c_write_register16(uint8_t devaddr, uint16_t regaddr, const uint8
 }
 
 i2c_status_t i2c_read_register(uint8_t devaddr, uint8_t regaddr, uint8_t* data, uint16_t length, uint16_t timeout) {
-    i2cStart(&I2C_DRIVER, &i2cconfig);
+    i2c_prologue();
     msg_t status = i2cMasterTransmitTimeout(&I2C_DRIVER, (devaddr >> 1), &regaddr, 1, data, length, TIME_MS2I(timeout));
     return i2c_epilogue(status);
 }
 
 i2c_status_t i2c_read_register16(uint8_t devaddr, uint16_t regaddr, uint8_t* data, uint16_t length, uint16_t timeout) {
-    i2cStart(&I2C_DRIVER, &i2cconfig);
+    i2c_prologue();
     uint8_t register_packet[2] = {regaddr >> 8, regaddr & 0xFF};
     msg_t   status             = i2cMasterTransmitTimeout(&I2C_DRIVER, (devaddr >> 1), register_packet, 2, data, length, TIME_MS2I(timeout));
     return i2c_epilogue(status);
@@ -47,3 +47,13 @@ i2c_status_t i2c_write_register16(uint8_t devaddr, uint16_t regaddr, const uint8
 i2c_status_t i2c_read_register(uint8_t devaddr, uint8_t regaddr, uint8_t* data, uint16_t length, uint16_t timeout);
 i2c_status_t i2c_read_register16(uint8_t devaddr, uint16_t regaddr, uint8_t* data, uint16_t length, uint16_t timeout);
 i2c_status_t i2c_ping_address(uint8_t address, uint16_t timeout);
+
+#ifdef I2C_QUEUE_ENABLE
+/* Queued writes are sent by a separate thread, and are not retried on
+ * failure, so the *_I2C_PERSISTENCE options of the LED drivers don't apply
+ * to them. i2c_queue_wait(), and every blocking function above, waits for
+ * that thread to empty the queue, and so must not be called from it.
+ */
+i2c_status_t i2c_queue_write_register(uint8_t devaddr, uint8_t regaddr, const uint8_t* data, uint16_t length, uint16_t timeout);
+i2c_status_t i2c_queue_wait(void);
+#endif
@@ -0,0 +1,249 @@
+// Copyright 2024 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+/*
+ * Timer triggered DMA matrix scanning for STM32.
+ *
+ * A timer runs at (rows x scan rate). On every update event, one DMA stream
+ * writes the next row strobe pattern into the row port's BSRR register. Part
+ * way through each period, a compare event on the same timer triggers a
+ * second DMA stream which snapshots the column port's IDR register into a
+ * circular buffer holding two complete frames.
+ *
+ * Scanning therefore costs no CPU time at all; matrix_scan_custom() only
+ * copies out the most recently completed frame and converts it into matrix
+ * rows if it differs from the previous one.
+ *
+ * Requirements:
+ *  - COL2ROW diode direction
+ *  - all row pins on a single GPIO port, all column pins on a single port
+ *  - a timer, and DMA streams which can reach the GPIO ports. On STM32F2/F4/F7
+ *    only DMA2 is able to access GPIO, so TIM1 or TIM8 must be used.
+ */
+
+#include <string.h>
+#include "matrix.h"
+#include "gpio.h"
+#include "chibios_config.h"
+
+#ifdef SPLIT_KEYBOARD
+#    include "split_common/split_util.h"
+#    define ROWS_PER_HAND (MATRIX_ROWS / 2)
+#else
+#    define ROWS_PER_HAND (MATRIX_ROWS)
+#endif
+
+#if !defined(STM32_DMA_STREAM)
+#    error "The DMA matrix driver currently only supports STM32 targets"
+#endif
+
+#if !defined(MATRIX_ROW_PINS) || !defined(MATRIX_COL_PINS)
+#    error "The DMA matrix driver requires MATRIX_ROW_PINS and MATRIX_COL_PINS"
+#endif
+
+#if defined(DIODE_DIRECTION) && (DIODE_DIRECTION != COL2ROW)
+#    error "The DMA matrix driver only supports COL2ROW diode direction"
+#endif
+
+#ifndef MATRIX_DMA_PWM_DRIVER
+#    define MATRIX_DMA_PWM_DRIVER PWMD1
+#endif
+#ifndef MATRIX_DMA_PWM_CHANNEL
+#    define MATRIX_DMA_PWM_CHANNEL 1 // Compare channel which triggers the column capture
+#endif
+#ifndef MATRIX_DMA_STROBE_STREAM
+#    define MATRIX_DMA_STROBE_STREAM STM32_DMA2_STREAM5 // DMA Stream for TIMx_UP
+#endif
+#ifndef MATRIX_DMA_STROBE_CHANNEL
+#    define MATRIX_DMA_STROBE_CHANNEL 6 // DMA Channel for TIMx_UP
+#endif
+#ifndef MATRIX_DMA_CAPTURE_STREAM
+#    define MATRIX_DMA_CAPTURE_STREAM STM32_DMA2_STREAM1 // DMA Stream for TIMx_CHy
+#endif
+#ifndef MATRIX_DMA_CAPTURE_CHANNEL
+#    define MATRIX_DMA_CAPTURE_CHANNEL 6 // DMA Channel for TIMx_CHy
+#endif
+#if (STM32_DMA_SUPPORTS_DMAMUX == TRUE) && (!defined(MATRIX_DMA_STROBE_DMAMUX_ID) || !defined(MATRIX_DMA_CAPTURE_DMAMUX_ID))
+#    error "please consult your MCU's datasheet and specify in your config.h: #define MATRIX_DMA_STROBE_DMAMUX_ID STM32_DMAMUX1_TIM?_UP and #define MATRIX_DMA_CAPTURE_DMAMUX_ID STM32_DMAMUX1_TIM?_CH?"
+#endif
+
+#ifndef MATRIX_DMA_SCAN_RATE
+#    define MATRIX_DMA_SCAN_RATE 10000 // Full matrix scans per second
+#endif
+#ifndef MATRIX_DMA_SAMPLE_POINT
+#    define MATRIX_DMA_SAMPLE_POINT 75 // Percentage of each row period to wait before sampling the columns
+#endif
+
+#define MATRIX_DMA_TIMER_FREQUENCY (CPU_CLOCK / 2)
+#define MATRIX_DMA_TIMER_PERIOD (MATRIX_DMA_TIMER_FREQUENCY / (MATRIX_DMA_SCAN_RATE * ROWS_PER_HAND))
+
+#if MATRIX_DMA_SAMPLE_POINT < 1 || MATRIX_DMA_SAMPLE_POINT > 99
+#    error "MATRIX_DMA_SAMPLE_POINT must be between 1 and 99"
+#endif
+
+#ifndef MATRIX_INPUT_PRESSED_STATE
+#    define MATRIX_INPUT_PRESSED_STATE 0
+#endif
+
+static pin_t row_pins[ROWS_PER_HAND] = MATRIX_ROW_PINS;
+static pin_t col_pins[MATRIX_COLS]   = MATRIX_COL_PINS;
+
+// BSRR values, entry n selects row (n + 1) so that it lines up with the capture of row n
+static uint32_t matrix_dma_strobe[ROWS_PER_HAND];
+// IDR snapshots, two complete frames
+static uint16_t matrix_dma_capture[2 * ROWS_PER_HAND];
+// Last frame converted into matrix rows
+static uint16_t matrix_dma_last_frame[ROWS_PER_HAND];
+
+static uint32_t matrix_dma_bsrr_select(uint8_t row) {
+    uint32_t bsrr = 0;
+    for (uint8_t r = 0; r < ROWS_PER_HAND; r++) {
+        if (row_pins[r] == NO_PIN) {
+            continue;
+        }
+        uint32_t pad_mask = 1UL << PAL_PAD(row_pins[r]);
+        // Selected row is driven low (BRx), every other row is driven high (BSx)
+        bsrr |= (r == row) ? (pad_mask << 16) : pad_mask;
+    }
+    return bsrr;
+}
+
+static stm32_gpio_t *matrix_dma_common_port(const pin_t *pins, uint8_t count) {
+    stm32_gpio_t *port = NULL;
+    for (uint8_t i = 0; i < count; i++) {
+        if (pins[i] == NO_PIN) {
+            continue;
+        }
+        if (port == NULL) {
+            port = PAL_PORT(pins[i]);
+        }
+        osalDbgAssert(port == PAL_PORT(pins[i]), "matrix_dma: pins must share a single GPIO port");
+    }
+    return port;
+}
+
+void matrix_init_custom(void) {
+#ifdef SPLIT_KEYBOARD
+#    ifdef MATRIX_ROW_PINS_RIGHT
+    if (!isLeftHand) {
+        const pin_t row_pins_right[ROWS_PER_HAND] = MATRIX_ROW_PINS_RIGHT;
+        memcpy(row_pins, row_pins_right, sizeof(row_pins));
+    }
+#    endif
+#    ifdef MATRIX_COL_PINS_RIGHT
+    if (!isLeftHand) {
+        const pin_t col_pins_right[MATRIX_COLS] = MATRIX_COL_PINS_RIGHT;
+        memcpy(col_pins, col_pins_right, sizeof(col_pins));
+    }
+#    endif
+#endif
+
+    for (uint8_t row = 0; row < ROWS_PER_HAND; row++) {
+        if (row_pins[row] != NO_PIN) {
+            gpio_set_pin_output_push_pull(row_pins[row]);
+            gpio_write_pin_high(row_pins[row]);
+        }
+    }
+    for (uint8_t col = 0; col < MATRIX_COLS; col++) {
+        if (col_pins[col] != NO_PIN) {
+            gpio_set_pin_input_high(col_pins[col]);
+        }
+    }
+
+    stm32_gpio_t *row_port = matrix_dma_common_port(row_pins, ROWS_PER_HAND);
+    stm32_gpio_t *col_port = matrix_dma_common_port(col_pins, MATRIX_COLS);
+
+    for (uint8_t row = 0; row < ROWS_PER_HAND; row++) {
+        matrix_dma_strobe[row] = matrix_dma_bsrr_select((row + 1) % ROWS_PER_HAND);
+    }
+    memset(matrix_dma_capture, 0xFF, sizeof(matrix_dma_capture));
+    memset(matrix_dma_last_frame, 0xFF, sizeof(matrix_dma_last_frame));
+
+    // Row 0 is selected up front, the first update event then moves on to row 1
+    if (row_pins[0] != NO_PIN) {
+        gpio_write_pin_low(row_pins[0]);
+    }
+
+    if (dmaStreamAlloc(MATRIX_DMA_STROBE_STREAM - STM32_DMA_STREAM(0), 10, NULL, NULL) == NULL) {
+        osalSysHalt("matrix_dma: unable to allocate the strobe DMA stream");
+    }
+    dmaStreamSetPeripheral(MATRIX_DMA_STROBE_STREAM, (void *)&row_port->BSRR);
+    dmaStreamSetMemory0(MATRIX_DMA_STROBE_STREAM, matrix_dma_strobe);
+    dmaStreamSetTransactionSize(MATRIX_DMA_STROBE_STREAM, ROWS_PER_HAND);
+    dmaStreamSetMode(MATRIX_DMA_STROBE_STREAM, STM32_DMA_CR_CHSEL(MATRIX_DMA_STROBE_CHANNEL) | STM32_DMA_CR_DIR_M2P | STM32_DMA_CR_PSIZE_WORD | STM32_DMA_CR_MSIZE_WORD | STM32_DMA_CR_MINC | STM32_DMA_CR_CIRC | STM32_DMA_CR_PL(3));
+
+    if (dmaStreamAlloc(MATRIX_DMA_CAPTURE_STREAM - STM32_DMA_STREAM(0), 10, NULL, NULL) == NULL) {
+        osalSysHalt("matrix_dma: unable to allocate the capture DMA stream");
+    }
+    dmaStreamSetPeripheral(MATRIX_DMA_CAPTURE_STREAM, &col_port->IDR);
+    dmaStreamSetMemory0(MATRIX_DMA_CAPTURE_STREAM, matrix_dma_capture);
+    dmaStreamSetTransactionSize(MATRIX_DMA_CAPTURE_STREAM, 2 * ROWS_PER_HAND);
+    dmaStreamSetMode(MATRIX_DMA_CAPTURE_STREAM, STM32_DMA_CR_CHSEL(MATRIX_DMA_CAPTURE_CHANNEL) | STM32_DMA_CR_DIR_P2M | STM32_DMA_CR_PSIZE_HWORD | STM32_DMA_CR_MSIZE_HWORD | STM32_DMA_CR_MINC | STM32_DMA_CR_CIRC | STM32_DMA_CR_PL(3));
+
+#if (STM32_DMA_SUPPORTS_DMAMUX == TRUE)
+    // If the MCU has a DMAMUX we need to assign the correct resource
+    dmaSetRequestSource(MATRIX_DMA_STROBE_STREAM, MATRIX_DMA_STROBE_DMAMUX_ID);
+    dmaSetRequestSource(MATRIX_DMA_CAPTURE_STREAM, MATRIX_DMA_CAPTURE_DMAMUX_ID);
+#endif
+
+    dmaStreamEnable(MATRIX_DMA_STROBE_STREAM);
+    dmaStreamEnable(MATRIX_DMA_CAPTURE_STREAM);
+
+    // The compare channel only generates DMA requests, its output stays disabled
+    static const PWMConfig matrix_dma_pwm_config = {
+        .frequency = MATRIX_DMA_TIMER_FREQUENCY,
+        .period    = MATRIX_DMA_TIMER_PERIOD,
+        .callback  = NULL,
+        .channels =
+            {
+                [0 ... 3] = {.mode = PWM_OUTPUT_DISABLED, .callback = NULL},
+            },
+        .cr2  = 0,
+        .dier = 0, // DMA requests are only enabled once the sample point is set, see below
+    };
+
+    pwmStart(&MATRIX_DMA_PWM_DRIVER, &matrix_dma_pwm_config);
+    pwmEnableChannel(&MATRIX_DMA_PWM_DRIVER, MATRIX_DMA_PWM_CHANNEL - 1, (MATRIX_DMA_TIMER_PERIOD * MATRIX_DMA_SAMPLE_POINT) / 100);
+
+    /* pwmStart() leaves the counter running with the compare register at 0.
+     * Restart it from the beginning of row 0 with both requests enabled at
+     * once, so that neither stream can run ahead of the other: an extra
+     * capture or strobe would leave the two rings a row out of step for good. */
+    stm32_tim_t *tim = MATRIX_DMA_PWM_DRIVER.tim;
+    tim->CR1 &= ~TIM_CR1_CEN;
+    tim->CNT = 0;
+    tim->SR  = 0;
+    tim->DIER |= TIM_DIER_UDE | (TIM_DIER_CC1DE << (MATRIX_DMA_PWM_CHANNEL - 1));
+    tim->CR1 |= TIM_CR1_CEN;
+}
+
+bool matrix_scan_custom(matrix_row_t current_matrix[]) {
+    uint16_t frame[ROWS_PER_HAND];
+
+    osalSysLock();
+    // Whichever half the capture stream is not currently writing to holds the last complete frame
+    size_t written = (2 * ROWS_PER_HAND) - dmaStreamGetTransactionSize(MATRIX_DMA_CAPTURE_STREAM);
+    memcpy(frame, &matrix_dma_capture[(written >= ROWS_PER_HAND) ? 0 : ROWS_PER_HAND], sizeof(frame));
+    osalSysUnlock();
+
+    if (memcmp(frame, matrix_dma_last_frame, sizeof(frame)) == 0) {
+        return false;
+    }
+    memcpy(matrix_dma_last_frame, frame, sizeof(frame));
+
+    bool changed = false;
+    for (uint8_t row = 0; row < ROWS_PER_HAND; row++) {
+        matrix_row_t row_value = 0;
+        if (row_pins[row] != NO_PIN) {
+            matrix_row_t row_shifter = MATRIX_ROW_SHIFTER;
+            for (uint8_t col = 0; col < MATRIX_COLS; col++, row_shifter <<= 1) {
+                if (col_pins[col] != NO_PIN && ((frame[row] >> PAL_PAD(col_pins[col])) & 1) == MATRIX_INPUT_PRESSED_STATE) {
+                    row_value |= row_shifter;
+                }
+            }
+        }
+        changed |= current_matrix[row] != row_value;
+        current_matrix[row] = row_value;
+    }
+    return changed;
+}
@@ -10,6 +10,27 @@
 static inline bool initiate_transaction(uint8_t transaction_id);
 static inline bool react_to_transaction(void);
 
+#ifdef SPLIT_TRANSACTION_BATCHING
+/**
+ * @brief Batched exchanges are followed by the used part of their payload,
+ * whose length is given in the frame header.
+ */
+static inline bool is_batch_transaction(const split_transaction_desc_t* transaction) {
+    return transaction == &split_transaction_table[EXCHANGE_BATCH];
+}
+
+static inline bool receive_batch_payload(split_batch_frame_t* frame) {
+    if (unlikely(frame->length > sizeof(frame->payload))) {
+        return false;
+    }
+    return frame->length == 0 || serial_transport_receive(frame->payload, frame->length);
+}
+
+static inline bool send_batch_payload(const split_batch_frame_t* frame) {
+    return frame->length == 0 || serial_transport_send(frame->payload, frame->length);
+}
+#endif // SPLIT_TRANSACTION_BATCHING
+
 /**
  * @brief This thread runs on the slave and responds to transactions initiated
  * by the master.
@@ -78,6 +99,14 @@ static inline bool react_to_transaction(void) {
         }
     }
 
+#ifdef SPLIT_TRANSACTION_BATCHING
+    if (is_batch_transaction(transaction)) {
+        if (unlikely(!receive_batch_payload(&split_shmem->batch_m2s))) {
+            return false;
+        }
+    }
+#endif // SPLIT_TRANSACTION_BATCHING
+
     /* Allow any slave processing to occur. */
     if (transaction->slave_callback) {
         transaction->slave_callback(transaction->initiator2target_buffer_size, split_trans_initiator2target_buffer(transaction), transaction->initiator2target_buffer_size, split_trans_target2initiator_buffer(transaction));
@@ -90,6 +119,14 @@ static inline bool react_to_transaction(void) {
         }
     }
 
+#ifdef SPLIT_TRANSACTION_BATCHING
+    if (is_batch_transaction(transaction)) {
+        if (unlikely(!send_batch_payload(&split_shmem->batch_s2m))) {
+            return false;
+        }
+    }
+#endif // SPLIT_TRANSACTION_BATCHING
+
     return true;
 }
 
@@ -146,6 +183,15 @@ static inline bool initiate_transaction(uint8_t transaction_id) {
         }
     }
 
+#ifdef SPLIT_TRANSACTION_BATCHING
+    if (is_batch_transaction(transaction)) {
+        if (unlikely(!send_batch_payload(&split_shmem->batch_m2s))) {
+            serial_dprintf("SPLIT: sending batch failed\n");
+            return false;
+        }
+    }
+#endif // SPLIT_TRANSACTION_BATCHING
+
     /* Receive transaction buffer from the slave. If this transaction requires it. */
     if (transaction->target2initiator_buffer_size) {
         if (unlikely(!serial_transport_receive(split_trans_target2initiator_buffer(transaction), transaction->target2initiator_buffer_size))) {
@@ -154,5 +200,14 @@ static inline bool initiate_transaction(uint8_t transaction_id) {
         }
     }
 
+#ifdef SPLIT_TRANSACTION_BATCHING
+    if (is_batch_transaction(transaction)) {
+        if (unlikely(!receive_batch_payload(&split_shmem->batch_s2m))) {
+            serial_dprintf("SPLIT: receiving batch failed\n");
+            return false;
+        }
+    }
+#endif // SPLIT_TRANSACTION_BATCHING
+
     return true;
 }
@@ -1,6 +1,7 @@
 #include "ws2812.h"
 #include "gpio.h"
 #include "chibios_config.h"
+#include <string.h>
 
 // ======== DEPRECATED DEFINES - DO NOT USE ========
 #ifdef WS2812_DMA_STREAM
@@ -90,10 +91,14 @@
 #define WS2812_PWM_PERIOD (WS2812_PWM_FREQUENCY / WS2812_PWM_TARGET_PERIOD) /**< Clock period in ticks. 1 / 800kHz = 1.25 uS (as per datasheet) */
 
 /**
- * @brief   Number of bit-periods to hold the data line low at the end of a frame
+ * @brief   Number of bit-periods to hold the data line low at the start of a frame
  *
  * The reset period for each frame is defined in WS2812_TRST_US.
- * Calculate the number of zeroes to add at the end assuming 1.25 uS/bit:
+ * Calculate the number of zeroes to add assuming 1.25 uS/bit.
+ *
+ * The reset bits come first so that, as the DMA stream wraps around at the end
+ * of a frame, the line is held low for the whole reset period. This leaves the
+ * transfer complete interrupt that much time to swap in the next frame.
  */
 #define WS2812_COLOR_BITS (WS2812_CHANNELS * 8)
 #define WS2812_RESET_BIT_N (1000 * WS2812_TRST_US / WS2812_TIMING)
@@ -148,7 +153,7 @@
  *
  * @return                          The bit index
  */
-#define WS2812_BIT(led, byte, bit) (WS2812_COLOR_BITS * (led) + 8 * (byte) + (7 - (bit)))
+#define WS2812_BIT(led, byte, bit) (WS2812_RESET_BIT_N + WS2812_COLOR_BITS * (led) + 8 * (byte) + (7 - (bit)))
 
 #if (WS2812_BYTE_ORDER == WS2812_BYTE_ORDER_GRB)
 /**
@@ -300,22 +305,107 @@ typedef uint16_t ws2812_buffer_t;
 typedef uint8_t ws2812_buffer_t;
 #endif
 
-static ws2812_buffer_t ws2812_frame_buffer[WS2812_BIT_N + 1]; /**< Buffer for a frame */
+#if defined(WB32F3G71xx) || defined(WB32FQ95xx)
+#    define WS2812_PWM_DMA_MODE (WB32_DMA_CHCFG_HWHIF(WS2812_PWM_DMA_CHANNEL) | WB32_DMA_CHCFG_DIR_M2P | WB32_DMA_CHCFG_PSIZE_WORD | WB32_DMA_CHCFG_MSIZE_WORD | WB32_DMA_CHCFG_MINC | WB32_DMA_CHCFG_CIRC | WB32_DMA_CHCFG_TCIE | WB32_DMA_CHCFG_PL(3))
+#elif defined(WS2812_PWM_DOUBLE_BUFFER)
+#    define WS2812_PWM_DMA_MODE (STM32_DMA_CR_CHSEL(WS2812_PWM_DMA_CHANNEL) | STM32_DMA_CR_DIR_M2P | WS2812_PWM_DMA_PERIPHERAL_WIDTH | WS2812_PWM_DMA_MEMORY_WIDTH | STM32_DMA_CR_MINC | STM32_DMA_CR_CIRC | STM32_DMA_CR_TCIE | STM32_DMA_CR_PL(3))
+#else
+#    define WS2812_PWM_DMA_MODE (STM32_DMA_CR_CHSEL(WS2812_PWM_DMA_CHANNEL) | STM32_DMA_CR_DIR_M2P | WS2812_PWM_DMA_PERIPHERAL_WIDTH | WS2812_PWM_DMA_MEMORY_WIDTH | STM32_DMA_CR_MINC | STM32_DMA_CR_CIRC | STM32_DMA_CR_PL(3))
+#endif
 
-/* --- PUBLIC FUNCTIONS ----------------------------------------------------- */
-/*
- * Gedanke: Double-buffer type transactions: double buffer transfers using two memory pointers for
- * the memory (while the DMA is reading/writing from/to a buffer, the application can
- * write/read to/from the other buffer).
+#ifdef WS2812_PWM_DOUBLE_BUFFER
+#    define WS2812_PWM_BUFFER_COUNT 2
+#else
+#    define WS2812_PWM_BUFFER_COUNT 1
+#endif
+
+static ws2812_buffer_t  ws2812_frame_buffers[WS2812_PWM_BUFFER_COUNT][WS2812_BIT_N + 1]; /**< Buffers for a frame */
+static ws2812_buffer_t* ws2812_frame_buffer = ws2812_frame_buffers[0];                   /**< Buffer the next frame is written to */
+
+/**
+ * @brief   Duty cycles for every possible nibble, MSB first
+ */
+#define WS2812_DUTYCYCLE(bit) ((bit) ? WS2812_DUTYCYCLE_1 : WS2812_DUTYCYCLE_0)
+#define WS2812_NIBBLE_LUT_ENTRY(nibble) {WS2812_DUTYCYCLE((nibble) & 8), WS2812_DUTYCYCLE((nibble) & 4), WS2812_DUTYCYCLE((nibble) & 2), WS2812_DUTYCYCLE((nibble) & 1)}
+
+static const ws2812_buffer_t ws2812_nibble_lut[16][4] = {
+    WS2812_NIBBLE_LUT_ENTRY(0),  WS2812_NIBBLE_LUT_ENTRY(1),  WS2812_NIBBLE_LUT_ENTRY(2),  WS2812_NIBBLE_LUT_ENTRY(3),
+    WS2812_NIBBLE_LUT_ENTRY(4),  WS2812_NIBBLE_LUT_ENTRY(5),  WS2812_NIBBLE_LUT_ENTRY(6),  WS2812_NIBBLE_LUT_ENTRY(7),
+    WS2812_NIBBLE_LUT_ENTRY(8),  WS2812_NIBBLE_LUT_ENTRY(9),  WS2812_NIBBLE_LUT_ENTRY(10), WS2812_NIBBLE_LUT_ENTRY(11),
+    WS2812_NIBBLE_LUT_ENTRY(12), WS2812_NIBBLE_LUT_ENTRY(13), WS2812_NIBBLE_LUT_ENTRY(14), WS2812_NIBBLE_LUT_ENTRY(15),
+};
+
+/**
+ * @brief   Write the duty cycles for one color byte, starting at its MSB
+ */
+static inline void ws2812_write_byte(uint32_t msb_bit, uint8_t data) {
+    memcpy(&ws2812_frame_buffer[msb_bit], ws2812_nibble_lut[data >> 4], sizeof(ws2812_nibble_lut[0]));
+    memcpy(&ws2812_frame_buffer[msb_bit + 4], ws2812_nibble_lut[data & 0x0F], sizeof(ws2812_nibble_lut[0]));
+}
+
+/**
+ * @brief   Point the DMA stream at a frame buffer and start streaming it to the timer
+ */
+static void ws2812_dma_start(ws2812_buffer_t* buffer) {
+#if defined(WB32F3G71xx) || defined(WB32FQ95xx)
+    dmaStreamSetSource(WS2812_PWM_DMA_STREAM, buffer);
+    dmaStreamSetDestination(WS2812_PWM_DMA_STREAM, &(WS2812_PWM_DRIVER.tim->CCR[WS2812_PWM_CHANNEL - 1])); // Ziel ist der An-Zeit im Cap-Comp-Register
+#else
+    dmaStreamSetPeripheral(WS2812_PWM_DMA_STREAM, &(WS2812_PWM_DRIVER.tim->CCR[WS2812_PWM_CHANNEL - 1])); // Ziel ist der An-Zeit im Cap-Comp-Register
+    dmaStreamSetMemory0(WS2812_PWM_DMA_STREAM, buffer);
+#endif
+    dmaStreamSetMode(WS2812_PWM_DMA_STREAM, WS2812_PWM_DMA_MODE);
+    dmaStreamSetTransactionSize(WS2812_PWM_DMA_STREAM, WS2812_BIT_N);
+    // M2P: Memory 2 Periph; PL: Priority Level
+
+    dmaStreamEnable(WS2812_PWM_DMA_STREAM);
+}
+
+#ifdef WS2812_PWM_DOUBLE_BUFFER
+static ws2812_buffer_t* volatile ws2812_pending_buffer = NULL; /**< Frame waiting to be streamed, if any */
+static binary_semaphore_t        ws2812_buffer_free;           /**< Signalled once the pending frame is being streamed */
+
+/**
+ * @brief   DMA transfer complete handler, called at the end of every frame
+ *
+ * The stream has just wrapped around to the reset bits at the start of the
+ * buffer, so the line stays low for WS2812_TRST_US while a pending frame is
+ * swapped in. Restarting the stream on the new buffer begins with its own
+ * reset bits, which only lengthens the reset period.
  */
+static void ws2812_dma_cb(void* param, uint32_t flags) {
+    (void)param;
+    (void)flags;
+
+    osalSysLockFromISR();
+    if (ws2812_pending_buffer != NULL) {
+        dmaStreamDisable(WS2812_PWM_DMA_STREAM);
+        ws2812_dma_start(ws2812_pending_buffer);
+        ws2812_pending_buffer = NULL;
+        chBSemSignalI(&ws2812_buffer_free);
+    }
+    osalSysUnlockFromISR();
+}
+#    define WS2812_PWM_DMA_CB ws2812_dma_cb
+#else
+#    define WS2812_PWM_DMA_CB NULL
+#endif
+
+/* --- PUBLIC FUNCTIONS ----------------------------------------------------- */
 
 void ws2812_init(void) {
-    // Initialize led frame buffer
-    uint32_t i;
-    for (i = 0; i < WS2812_COLOR_BIT_N; i++)
-        ws2812_frame_buffer[i] = WS2812_DUTYCYCLE_0; // All color bits are zero duty cycle
-    for (i = 0; i < WS2812_RESET_BIT_N; i++)
-        ws2812_frame_buffer[i + WS2812_COLOR_BIT_N] = 0; // All reset bits are zero
+    // Initialize led frame buffers
+    for (uint8_t n = 0; n < WS2812_PWM_BUFFER_COUNT; n++) {
+        uint32_t i;
+        for (i = 0; i < WS2812_RESET_BIT_N; i++)
+            ws2812_frame_buffers[n][i] = 0; // All reset bits are zero
+        for (i = 0; i < WS2812_COLOR_BIT_N; i++)
+            ws2812_frame_buffers[n][i + WS2812_RESET_BIT_N] = WS2812_DUTYCYCLE_0; // All color bits are zero duty cycle
+    }
+#ifdef WS2812_PWM_DOUBLE_BUFFER
+    chBSemObjectInit(&ws2812_buffer_free, false);
+    ws2812_frame_buffer = ws2812_frame_buffers[1];
+#endif
 
     palSetLineMode(WS2812_DI_PIN, WS2812_OUTPUT_MODE);
 
@@ -338,18 +428,10 @@ void ws2812_init(void) {
     // Configure DMA
     // dmaInit(); // Joe added this
 #if defined(WB32F3G71xx) || defined(WB32FQ95xx)
-    dmaStreamAlloc(WS2812_PWM_DMA_STREAM - WB32_DMA_STREAM(0), 10, NULL, NULL);
-    dmaStreamSetSource(WS2812_PWM_DMA_STREAM, ws2812_frame_buffer);
-    dmaStreamSetDestination(WS2812_PWM_DMA_STREAM, &(WS2812_PWM_DRIVER.tim->CCR[WS2812_PWM_CHANNEL - 1])); // Ziel ist der An-Zeit im Cap-Comp-Register
-    dmaStreamSetMode(WS2812_PWM_DMA_STREAM, WB32_DMA_CHCFG_HWHIF(WS2812_PWM_DMA_CHANNEL) | WB32_DMA_CHCFG_DIR_M2P | WB32_DMA_CHCFG_PSIZE_WORD | WB32_DMA_CHCFG_MSIZE_WORD | WB32_DMA_CHCFG_MINC | WB32_DMA_CHCFG_CIRC | WB32_DMA_CHCFG_TCIE | WB32_DMA_CHCFG_PL(3));
+    dmaStreamAlloc(WS2812_PWM_DMA_STREAM - WB32_DMA_STREAM(0), 10, WS2812_PWM_DMA_CB, NULL);
 #else
-    dmaStreamAlloc(WS2812_PWM_DMA_STREAM - STM32_DMA_STREAM(0), 10, NULL, NULL);
-    dmaStreamSetPeripheral(WS2812_PWM_DMA_STREAM, &(WS2812_PWM_DRIVER.tim->CCR[WS2812_PWM_CHANNEL - 1])); // Ziel ist der An-Zeit im Cap-Comp-Register
-    dmaStreamSetMemory0(WS2812_PWM_DMA_STREAM, ws2812_frame_buffer);
-    dmaStreamSetMode(WS2812_PWM_DMA_STREAM, STM32_DMA_CR_CHSEL(WS2812_PWM_DMA_CHANNEL) | STM32_DMA_CR_DIR_M2P | WS2812_PWM_DMA_PERIPHERAL_WIDTH | WS2812_PWM_DMA_MEMORY_WIDTH | STM32_DMA_CR_MINC | STM32_DMA_CR_CIRC | STM32_DMA_CR_PL(3));
+    dmaStreamAlloc(WS2812_PWM_DMA_STREAM - STM32_DMA_STREAM(0), 10, WS2812_PWM_DMA_CB, NULL);
 #endif
-    dmaStreamSetTransactionSize(WS2812_PWM_DMA_STREAM, WS2812_BIT_N);
-    // M2P: Memory 2 Periph; PL: Priority Level
 
 #if (STM32_DMA_SUPPORTS_DMAMUX == TRUE)
     // If the MCU has a DMAMUX we need to assign the correct resource
@@ -357,7 +439,7 @@ void ws2812_init(void) {
 #endif
 
     // Start DMA
-    dmaStreamEnable(WS2812_PWM_DMA_STREAM);
+    ws2812_dma_start(ws2812_frame_buffers[0]);
 
     // Configure PWM
     // NOTE: It's required that preload be enabled on the timer channel CCR register. This is currently enabled in the
@@ -369,26 +451,27 @@ void ws2812_init(void) {
 
 void ws2812_write_led(uint16_t led_number, uint8_t r, uint8_t g, uint8_t b) {
     // Write color to frame buffer
-    for (uint8_t bit = 0; bit < 8; bit++) {
-        ws2812_frame_buffer[WS2812_RED_BIT(led_number, bit)]   = ((r >> bit) & 0x01) ? WS2812_DUTYCYCLE_1 : WS2812_DUTYCYCLE_0;
-        ws2812_frame_buffer[WS2812_GREEN_BIT(led_number, bit)] = ((g >> bit) & 0x01) ? WS2812_DUTYCYCLE_1 : WS2812_DUTYCYCLE_0;
-        ws2812_frame_buffer[WS2812_BLUE_BIT(led_number, bit)]  = ((b >> bit) & 0x01) ? WS2812_DUTYCYCLE_1 : WS2812_DUTYCYCLE_0;
-    }
+    ws2812_write_byte(WS2812_RED_BIT(led_number, 7), r);
+    ws2812_write_byte(WS2812_GREEN_BIT(led_number, 7), g);
+    ws2812_write_byte(WS2812_BLUE_BIT(led_number, 7), b);
 }
 void ws2812_write_led_rgbw(uint16_t led_number, uint8_t r, uint8_t g, uint8_t b, uint8_t w) {
     // Write color to frame buffer
-    for (uint8_t bit = 0; bit < 8; bit++) {
-        ws2812_frame_buffer[WS2812_RED_BIT(led_number, bit)]   = ((r >> bit) & 0x01) ? WS2812_DUTYCYCLE_1 : WS2812_DUTYCYCLE_0;
-        ws2812_frame_buffer[WS2812_GREEN_BIT(led_number, bit)] = ((g >> bit) & 0x01) ? WS2812_DUTYCYCLE_1 : WS2812_DUTYCYCLE_0;
-        ws2812_frame_buffer[WS2812_BLUE_BIT(led_number, bit)]  = ((b >> bit) & 0x01) ? WS2812_DUTYCYCLE_1 : WS2812_DUTYCYCLE_0;
+    ws2812_write_byte(WS2812_RED_BIT(led_number, 7), r);
+    ws2812_write_byte(WS2812_GREEN_BIT(led_number, 7), g);
+    ws2812_write_byte(WS2812_BLUE_BIT(led_number, 7), b);
 #ifdef WS2812_RGBW
-        ws2812_frame_buffer[WS2812_WHITE_BIT(led_number, bit)] = ((w >> bit) & 0x01) ? WS2812_DUTYCYCLE_1 : WS2812_DUTYCYCLE_0;
+    ws2812_write_byte(WS2812_WHITE_BIT(led_number, 7), w);
 #endif
-    }
 }
 
 // Setleds for standard RGB
 void ws2812_setleds(rgb_led_t* ledarray, uint16_t leds) {
+#ifdef WS2812_PWM_DOUBLE_BUFFER
+    // Wait until the previous frame is being streamed, its buffer is then the only one in use
+    chBSemWait(&ws2812_buffer_free);
+#endif
+
     for (uint16_t i = 0; i < leds; i++) {
 #ifdef WS2812_RGBW
         ws2812_write_led_rgbw(i, ledarray[i].r, ledarray[i].g, ledarray[i].b, ledarray[i].w);
@@ -396,4 +479,12 @@ void ws2812_setleds(rgb_led_t* ledarray, uint16_t leds) {
         ws2812_write_led(i, ledarray[i].r, ledarray[i].g, ledarray[i].b);
 #endif
     }
+
+#ifdef WS2812_PWM_DOUBLE_BUFFER
+    // Have the frame swapped in once the current one ends, and write the next one to the other buffer
+    osalSysLock();
+    ws2812_pending_buffer = ws2812_frame_buffer;
+    osalSysUnlock();
+    ws2812_frame_buffer = ws2812_frame_buffer == ws2812_frame_buffers[0] ? ws2812_frame_buffers[1] : ws2812_frame_buffers[0];
+#endif
 }
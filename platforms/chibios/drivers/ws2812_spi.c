@@ -2,6 +2,7 @@
 #include "gpio.h"
 #include "util.h"
 #include "chibios_config.h"
+#include <string.h>
 
 /* Adapted from https://github.com/gamazeps/ws2812b-chibios-SPIDMA/ */
 
@@ -69,6 +70,18 @@
 #    define WS2812_SPI_BUFFER_MODE 0 // normal buffer
 #endif
 
+// Encode the next frame while the previous one is being sent
+#ifdef WS2812_SPI_DOUBLE_BUFFER
+#    if defined(WS2812_SPI_USE_CIRCULAR_BUFFER) || defined(WS2812_SPI_SYNC)
+#        error "WS2812_SPI_DOUBLE_BUFFER cannot be used with WS2812_SPI_USE_CIRCULAR_BUFFER or WS2812_SPI_SYNC"
+#    endif
+#    define WS2812_SPI_BUFFER_COUNT 2
+#    define WS2812_SPI_END_CB ws2812_spi_end_cb
+#else
+#    define WS2812_SPI_BUFFER_COUNT 1
+#    define WS2812_SPI_END_CB NULL
+#endif
+
 #if defined(USE_GPIOV1)
 #    define WS2812_SCK_OUTPUT_MODE PAL_MODE_ALTERNATE_PUSHPULL
 #else
@@ -85,58 +98,70 @@
 #define DATA_SIZE (BYTES_FOR_LED * WS2812_LED_COUNT)
 #define RESET_SIZE (1000 * WS2812_TRST_US / (2 * WS2812_TIMING))
 #define PREAMBLE_SIZE 4
+#define TXBUF_SIZE (PREAMBLE_SIZE + DATA_SIZE + RESET_SIZE)
 
-static uint8_t txbuf[PREAMBLE_SIZE + DATA_SIZE + RESET_SIZE] = {0};
+static uint8_t  txbufs[WS2812_SPI_BUFFER_COUNT][TXBUF_SIZE] = {0};
+static uint8_t* txbuf                                       = txbufs[0];
 
 /*
  * As the trick here is to use the SPI to send a huge pattern of 0 and 1 to
- * the ws2812b protocol, we use this helper function to translate bytes into
- * 0s and 1s for the LED (with the appropriate timing).
+ * the ws2812b protocol, each SPI byte carries two LED bits: 0b1000 for a 0
+ * and 0b1110 for a 1 (with the appropriate timing). The lookup table holds
+ * the four SPI bytes for every possible LED byte, MSB first.
  */
-static uint8_t get_protocol_eq(uint8_t data, int pos) {
-    uint8_t eq = 0;
-    if (data & (1 << (2 * (3 - pos))))
-        eq = 0b1110;
-    else
-        eq = 0b1000;
-    if (data & (2 << (2 * (3 - pos))))
-        eq += 0b11100000;
-    else
-        eq += 0b10000000;
-    return eq;
+#define WS2812_SPI_SYMBOL(bits) ((((bits) & 2) ? 0b11100000 : 0b10000000) | (((bits) & 1) ? 0b1110 : 0b1000))
+#define WS2812_SPI_LUT_ENTRY(data) { WS2812_SPI_SYMBOL((data) >> 6), WS2812_SPI_SYMBOL((data) >> 4), WS2812_SPI_SYMBOL((data) >> 2), WS2812_SPI_SYMBOL(data) }
+#define WS2812_SPI_LUT_4(data) WS2812_SPI_LUT_ENTRY(data), WS2812_SPI_LUT_ENTRY((data) + 1), WS2812_SPI_LUT_ENTRY((data) + 2), WS2812_SPI_LUT_ENTRY((data) + 3)
+#define WS2812_SPI_LUT_16(data) WS2812_SPI_LUT_4(data), WS2812_SPI_LUT_4((data) + 4), WS2812_SPI_LUT_4((data) + 8), WS2812_SPI_LUT_4((data) + 12)
+#define WS2812_SPI_LUT_64(data) WS2812_SPI_LUT_16(data), WS2812_SPI_LUT_16((data) + 16), WS2812_SPI_LUT_16((data) + 32), WS2812_SPI_LUT_16((data) + 48)
+
+static const uint8_t ws2812_spi_lut[256][BYTES_FOR_LED_BYTE] = {
+    WS2812_SPI_LUT_64(0),
+    WS2812_SPI_LUT_64(64),
+    WS2812_SPI_LUT_64(128),
+    WS2812_SPI_LUT_64(192),
+};
+
+static inline void set_led_byte(uint8_t* tx, uint8_t data) {
+    memcpy(tx, ws2812_spi_lut[data], BYTES_FOR_LED_BYTE);
 }
 
 static void set_led_color_rgb(rgb_led_t color, int pos) {
-    uint8_t* tx_start = &txbuf[PREAMBLE_SIZE];
+    uint8_t* tx_start = &txbuf[PREAMBLE_SIZE + BYTES_FOR_LED * pos];
 
 #if (WS2812_BYTE_ORDER == WS2812_BYTE_ORDER_GRB)
-    for (int j = 0; j < 4; j++)
-        tx_start[BYTES_FOR_LED * pos + j] = get_protocol_eq(color.g, j);
-    for (int j = 0; j < 4; j++)
-        tx_start[BYTES_FOR_LED * pos + BYTES_FOR_LED_BYTE + j] = get_protocol_eq(color.r, j);
-    for (int j = 0; j < 4; j++)
-        tx_start[BYTES_FOR_LED * pos + BYTES_FOR_LED_BYTE * 2 + j] = get_protocol_eq(color.b, j);
+    set_led_byte(tx_start, color.g);
+    set_led_byte(tx_start + BYTES_FOR_LED_BYTE, color.r);
+    set_led_byte(tx_start + BYTES_FOR_LED_BYTE * 2, color.b);
 #elif (WS2812_BYTE_ORDER == WS2812_BYTE_ORDER_RGB)
-    for (int j = 0; j < 4; j++)
-        tx_start[BYTES_FOR_LED * pos + j] = get_protocol_eq(color.r, j);
-    for (int j = 0; j < 4; j++)
-        tx_start[BYTES_FOR_LED * pos + BYTES_FOR_LED_BYTE + j] = get_protocol_eq(color.g, j);
-    for (int j = 0; j < 4; j++)
-        tx_start[BYTES_FOR_LED * pos + BYTES_FOR_LED_BYTE * 2 + j] = get_protocol_eq(color.b, j);
+    set_led_byte(tx_start, color.r);
+    set_led_byte(tx_start + BYTES_FOR_LED_BYTE, color.g);
+    set_led_byte(tx_start + BYTES_FOR_LED_BYTE * 2, color.b);
 #elif (WS2812_BYTE_ORDER == WS2812_BYTE_ORDER_BGR)
-    for (int j = 0; j < 4; j++)
-        tx_start[BYTES_FOR_LED * pos + j] = get_protocol_eq(color.b, j);
-    for (int j = 0; j < 4; j++)
-        tx_start[BYTES_FOR_LED * pos + BYTES_FOR_LED_BYTE + j] = get_protocol_eq(color.g, j);
-    for (int j = 0; j < 4; j++)
-        tx_start[BYTES_FOR_LED * pos + BYTES_FOR_LED_BYTE * 2 + j] = get_protocol_eq(color.r, j);
+    set_led_byte(tx_start, color.b);
+    set_led_byte(tx_start + BYTES_FOR_LED_BYTE, color.g);
+    set_led_byte(tx_start + BYTES_FOR_LED_BYTE * 2, color.r);
 #endif
 #ifdef WS2812_RGBW
-    for (int j = 0; j < 4; j++)
-        tx_start[BYTES_FOR_LED * pos + BYTES_FOR_LED_BYTE * 4 + j] = get_protocol_eq(color.w, j);
+    set_led_byte(tx_start + BYTES_FOR_LED_BYTE * 3, color.w);
 #endif
 }
 
+#ifdef WS2812_SPI_DOUBLE_BUFFER
+static binary_semaphore_t tx_idle;
+
+/*
+ * Called from the SPI interrupt once a frame has been sent, which frees up
+ * the driver for the next one.
+ */
+static void ws2812_spi_end_cb(SPIDriver* spip) {
+    (void)spip;
+    osalSysLockFromISR();
+    chBSemSignalI(&tx_idle);
+    osalSysUnlockFromISR();
+}
+#endif
+
 void ws2812_init(void) {
     palSetLineMode(WS2812_DI_PIN, WS2812_MOSI_OUTPUT_MODE);
 
@@ -151,7 +176,7 @@ void ws2812_init(void) {
 #    if SPI_SUPPORTS_CIRCULAR == TRUE
         WS2812_SPI_BUFFER_MODE,
 #    endif
-        NULL, // end_cb
+        WS2812_SPI_END_CB, // end_cb
         PAL_PORT(WS2812_DI_PIN),
         PAL_PAD(WS2812_DI_PIN),
 #    if defined(WB32F3G71xx) || defined(WB32FQ95xx)
@@ -170,8 +195,8 @@ void ws2812_init(void) {
 #    if SPI_SUPPORTS_SLAVE_MODE == TRUE
         false,
 #    endif
-        NULL, // data_cb
-        NULL, // error_cb
+        WS2812_SPI_END_CB, // data_cb
+        NULL,              // error_cb
         PAL_PORT(WS2812_DI_PIN),
         PAL_PAD(WS2812_DI_PIN),
         WS2812_SPI_DIVISOR_CR1_BR_X,
@@ -179,26 +204,36 @@ void ws2812_init(void) {
 #endif
     };
 
+#ifdef WS2812_SPI_DOUBLE_BUFFER
+    chBSemObjectInit(&tx_idle, false);
+#endif
+
     spiAcquireBus(&WS2812_SPI_DRIVER);     /* Acquire ownership of the bus.    */
     spiStart(&WS2812_SPI_DRIVER, &spicfg); /* Setup transfer parameters.       */
     spiSelect(&WS2812_SPI_DRIVER);         /* Slave Select assertion.          */
 #ifdef WS2812_SPI_USE_CIRCULAR_BUFFER
-    spiStartSend(&WS2812_SPI_DRIVER, ARRAY_SIZE(txbuf), txbuf);
+    spiStartSend(&WS2812_SPI_DRIVER, TXBUF_SIZE, txbuf);
 #endif
 }
 
 void ws2812_setleds(rgb_led_t* ledarray, uint16_t leds) {
-    for (uint8_t i = 0; i < leds; i++) {
+    for (uint16_t i = 0; i < leds; i++) {
         set_led_color_rgb(ledarray[i], i);
     }
 
+#if defined(WS2812_SPI_DOUBLE_BUFFER)
+    // Wait for the previous frame to finish, send this one, and encode the
+    // next frame into the other buffer while this one is being sent.
+    chBSemWait(&tx_idle);
+    spiStartSend(&WS2812_SPI_DRIVER, TXBUF_SIZE, txbuf);
+    txbuf = txbuf == txbufs[0] ? txbufs[1] : txbufs[0];
+#elif !defined(WS2812_SPI_USE_CIRCULAR_BUFFER)
     // Send async - each led takes ~0.03ms, 50 leds ~1.5ms, animations flushing faster than send will cause issues.
-    // Instead spiSend can be used to send synchronously (or the thread logic can be added back).
-#ifndef WS2812_SPI_USE_CIRCULAR_BUFFER
+    // Instead spiSend can be used to send synchronously, or WS2812_SPI_DOUBLE_BUFFER to keep sending asynchronously.
 #    ifdef WS2812_SPI_SYNC
-    spiSend(&WS2812_SPI_DRIVER, ARRAY_SIZE(txbuf), txbuf);
+    spiSend(&WS2812_SPI_DRIVER, TXBUF_SIZE, txbuf);
 #    else
-    spiStartSend(&WS2812_SPI_DRIVER, ARRAY_SIZE(txbuf), txbuf);
+    spiStartSend(&WS2812_SPI_DRIVER, TXBUF_SIZE, txbuf);
 #    endif
 #endif
 }
@@ -0,0 +1,27 @@
+// Copyright 2024 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** \brief Read a free-running, high resolution counter
+ *
+ * The unit is platform specific -- CPU cycles on ChibiOS targets with a
+ * realtime counter, prescaled timer ticks on AVR, nanoseconds on the test
+ * platform. Only differences between two reads are meaningful, and the
+ * counter is expected to wrap.
+ */
+uint32_t cycle_counter_read(void);
+
+/** \brief Convert a duration in microseconds to cycle counter units
+ */
+uint32_t cycle_counter_from_us(uint32_t us);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,15 @@
+// Copyright 2024 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <time.h>
+#include "cycle_counter.h"
+
+uint32_t cycle_counter_read(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint32_t)((uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec);
+}
+
+uint32_t cycle_counter_from_us(uint32_t us) {
+    return us * 1000;
+}
@@ -316,16 +316,14 @@ action_t store_or_get_action(bool pressed, keypos_t key) {
 #endif
 }
 
-/** \brief Layer switch get layer
+#ifndef NO_ACTION_LAYER
+/** \brief Layer switch find layer
  *
- * Gets the layer based on key info
+ * Returns the topmost layer in the given state for which the key is not transparent, or -1 if there is none
  */
-uint8_t layer_switch_get_layer(keypos_t key) {
-#ifndef NO_ACTION_LAYER
+static int8_t layer_switch_find_layer(keypos_t key, layer_state_t layers) {
     action_t action;
-    action.code = ACTION_TRANSPARENT;
 
-    layer_state_t layers = layer_state | default_layer_state;
     /* check top layer first */
     for (int8_t i = MAX_LAYER - 1; i >= 0; i--) {
         if (layers & ((layer_state_t)1 << i)) {
@@ -335,8 +333,82 @@ uint8_t layer_switch_get_layer(keypos_t key) {
             }
         }
     }
+    return -1;
+}
+#endif
+
+#if defined(LAYER_LOOKUP_CACHE) && !defined(NO_ACTION_LAYER)
+/* resolved layer for every matrix position, valid for layer_lookup_cache_state */
+static uint8_t       layer_lookup_cache[MATRIX_ROWS][MATRIX_COLS];
+static layer_state_t layer_lookup_cache_state = 0;
+static bool          layer_lookup_cache_valid = false;
+
+/** \brief Layer lookup cache invalidate
+ *
+ * Forces a full rebuild of the lookup table on the next key event, must be called whenever the keymap changes
+ */
+void layer_lookup_cache_invalidate(void) {
+    layer_lookup_cache_valid = false;
+}
+
+/** \brief Layer lookup cache update
+ *
+ * Brings the lookup table in line with the given layer state. Only the layers which changed since the last update are
+ * inspected: layers which stayed on above a key's resolved layer are known to be transparent for that key.
+ */
+static void layer_lookup_cache_update(layer_state_t layers) {
+    layer_state_t added   = layers & ~layer_lookup_cache_state;
+    layer_state_t removed = layer_lookup_cache_state & ~layers;
+
+    for (uint8_t row = 0; row < MATRIX_ROWS; row++) {
+        for (uint8_t col = 0; col < MATRIX_COLS; col++) {
+            keypos_t key    = MAKE_KEYPOS(row, col);
+            uint8_t *cached = &layer_lookup_cache[row][col];
+            int8_t   layer;
+
+            if (!layer_lookup_cache_valid) {
+                layer = layer_switch_find_layer(key, layers);
+            } else {
+                layer_state_t cached_bit = (layer_state_t)1 << *cached;
+
+                layer = layer_switch_find_layer(key, added & ~(cached_bit | (cached_bit - 1)));
+                if (layer < 0) {
+                    if (!(removed & cached_bit)) {
+                        continue;
+                    }
+                    layer = layer_switch_find_layer(key, layers & (cached_bit - 1));
+                }
+            }
+            /* fall back to layer 0 */
+            *cached = layer < 0 ? 0 : layer;
+        }
+    }
+
+    layer_lookup_cache_state = layers;
+    layer_lookup_cache_valid = true;
+}
+#endif
+
+/** \brief Layer switch get layer
+ *
+ * Gets the layer based on key info
+ */
+uint8_t layer_switch_get_layer(keypos_t key) {
+#ifndef NO_ACTION_LAYER
+    layer_state_t layers = layer_state | default_layer_state;
+
+#    ifdef LAYER_LOOKUP_CACHE
+    if (key.row < MATRIX_ROWS && key.col < MATRIX_COLS) {
+        if (!layer_lookup_cache_valid || layers != layer_lookup_cache_state) {
+            layer_lookup_cache_update(layers);
+        }
+        return layer_lookup_cache[key.row][key.col];
+    }
+#    endif
+
+    int8_t layer = layer_switch_find_layer(key, layers);
     /* fall back to layer 0 */
-    return 0;
+    return layer < 0 ? 0 : layer;
 #else
     return get_highest_layer(default_layer_state);
 #endif
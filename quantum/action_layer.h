@@ -166,5 +166,12 @@ action_t store_or_get_action(bool pressed, keypos_t key);
 /* return the topmost non-transparent layer currently associated with key */
 uint8_t layer_switch_get_layer(keypos_t key);
 
+#if defined(LAYER_LOOKUP_CACHE) && !defined(NO_ACTION_LAYER)
+/* discard the resolved layer of every key, to be called whenever the keymap is changed at runtime */
+void layer_lookup_cache_invalidate(void);
+#else
+#    define layer_lookup_cache_invalidate()
+#endif
+
 /* return action depending on current layer status */
 action_t layer_switch_get_action(keypos_t key);
@@ -19,82 +19,67 @@
 #include "progmem.h"
 #include "util.h"
 
-RGB hsv_to_rgb_impl(HSV hsv, bool use_cie) {
-    RGB      rgb;
-    uint8_t  region, remainder, p, q, t;
-    uint16_t h, s, v;
+// Which of v, p, q and t ends up in each channel, for every hue region and for
+// grey (no saturation)
+enum { HSV_V, HSV_P, HSV_Q, HSV_T };
+
+static const uint8_t hsv_region_channels[8][3] PROGMEM = {
+    {HSV_V, HSV_T, HSV_P}, // red to yellow
+    {HSV_Q, HSV_V, HSV_P}, // yellow to green
+    {HSV_P, HSV_V, HSV_T}, // green to cyan
+    {HSV_P, HSV_Q, HSV_V}, // cyan to blue
+    {HSV_T, HSV_P, HSV_V}, // blue to magenta
+    {HSV_V, HSV_P, HSV_Q}, // magenta to red
+    {HSV_V, HSV_T, HSV_P}, // h == 255 wraps around to red
+    {HSV_V, HSV_V, HSV_V}, // s == 0
+};
+
+/**
+ * Converts a single color without any branches, with the value already run
+ * through the CIE curve if needed. Dividing by 255 is done with shifts, as it
+ * is a library call on AVR and Cortex-M0 targets.
+ */
+static inline RGB hsv_to_rgb_core(uint8_t h, uint8_t s, uint8_t v) {
+    uint16_t h6        = h * 6;
+    uint8_t  region    = (h6 + 1 + (h6 >> 8)) >> 8;
+    uint8_t  remainder = (h * 2 - region * 85) * 3;
+    uint8_t  channels[4];
+
+    channels[HSV_V] = v;
+    channels[HSV_P] = (v * (255 - s)) >> 8;
+    channels[HSV_Q] = (v * (255 - ((s * remainder) >> 8))) >> 8;
+    channels[HSV_T] = (v * (255 - ((s * (255 - remainder)) >> 8))) >> 8;
+
+    region |= -(uint8_t)(s == 0) & 7;
+
+    RGB rgb;
+    rgb.r = channels[pgm_read_byte(&hsv_region_channels[region][0])];
+    rgb.g = channels[pgm_read_byte(&hsv_region_channels[region][1])];
+    rgb.b = channels[pgm_read_byte(&hsv_region_channels[region][2])];
+    return rgb;
+}
 
-    if (hsv.s == 0) {
+RGB hsv_to_rgb_impl(HSV hsv, bool use_cie) {
 #ifdef USE_CIE1931_CURVE
-        if (use_cie) {
-            rgb.r = rgb.g = rgb.b = pgm_read_byte(&CIE1931_CURVE[hsv.v]);
-        } else {
-            rgb.r = hsv.v;
-            rgb.g = hsv.v;
-            rgb.b = hsv.v;
-        }
-#else
-        rgb.r = hsv.v;
-        rgb.g = hsv.v;
-        rgb.b = hsv.v;
-#endif
-        return rgb;
+    if (use_cie) {
+        return hsv_to_rgb_core(hsv.h, hsv.s, pgm_read_byte(&CIE1931_CURVE[hsv.v]));
     }
+#endif
+    return hsv_to_rgb_core(hsv.h, hsv.s, hsv.v);
+}
 
-    h = hsv.h;
-    s = hsv.s;
+static void hsv_to_rgb_batch_impl(const HSV *hsv, RGB *rgb, uint16_t count, bool use_cie) {
 #ifdef USE_CIE1931_CURVE
     if (use_cie) {
-        v = pgm_read_byte(&CIE1931_CURVE[hsv.v]);
-    } else {
-        v = hsv.v;
+        for (uint16_t i = 0; i < count; i++) {
+            rgb[i] = hsv_to_rgb_core(hsv[i].h, hsv[i].s, pgm_read_byte(&CIE1931_CURVE[hsv[i].v]));
+        }
+        return;
     }
-#else
-    v = hsv.v;
 #endif
-
-    region    = h * 6 / 255;
-    remainder = (h * 2 - region * 85) * 3;
-
-    p = (v * (255 - s)) >> 8;
-    q = (v * (255 - ((s * remainder) >> 8))) >> 8;
-    t = (v * (255 - ((s * (255 - remainder)) >> 8))) >> 8;
-
-    switch (region) {
-        case 6:
-        case 0:
-            rgb.r = v;
-            rgb.g = t;
-            rgb.b = p;
-            break;
-        case 1:
-            rgb.r = q;
-            rgb.g = v;
-            rgb.b = p;
-            break;
-        case 2:
-            rgb.r = p;
-            rgb.g = v;
-            rgb.b = t;
-            break;
-        case 3:
-            rgb.r = p;
-            rgb.g = q;
-            rgb.b = v;
-            break;
-        case 4:
-            rgb.r = t;
-            rgb.g = p;
-            rgb.b = v;
-            break;
-        default:
-            rgb.r = v;
-            rgb.g = p;
-            rgb.b = q;
-            break;
+    for (uint16_t i = 0; i < count; i++) {
+        rgb[i] = hsv_to_rgb_core(hsv[i].h, hsv[i].s, hsv[i].v);
     }
-
-    return rgb;
 }
 
 RGB hsv_to_rgb(HSV hsv) {
@@ -109,6 +94,14 @@ RGB hsv_to_rgb_nocie(HSV hsv) {
     return hsv_to_rgb_impl(hsv, false);
 }
 
+void hsv_to_rgb_batch(const HSV *hsv, RGB *rgb, uint16_t count) {
+#ifdef USE_CIE1931_CURVE
+    hsv_to_rgb_batch_impl(hsv, rgb, count, true);
+#else
+    hsv_to_rgb_batch_impl(hsv, rgb, count, false);
+#endif
+}
+
 #ifdef WS2812_RGBW
 void convert_rgb_to_rgbw(rgb_led_t *led) {
     // Determine lowest value in all three colors, put that into
@@ -0,0 +1,168 @@
+// Copyright 2024 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+/*
+Bit-sliced symmetric per-key algorithm. Behaves exactly like sym_defer_pk, but
+instead of an 8-bit counter per key, the counters are stored "vertically": bit
+n of every counter in a row lives in bit-plane n, a single matrix_row_t. This
+lets a whole row of counters be loaded, decremented and checked for expiry with
+a handful of word-wide operations, independently of the number of columns, and
+without any heap allocation.
+When no state changes have occured for DEBOUNCE milliseconds, we push the state.
+*/
+
+#include "debounce.h"
+#include "timer.h"
+#include <string.h>
+
+#ifndef DEBOUNCE
+#    define DEBOUNCE 5
+#endif
+
+// Maximum debounce: 255ms
+#if DEBOUNCE > UINT8_MAX
+#    undef DEBOUNCE
+#    define DEBOUNCE UINT8_MAX
+#endif
+
+#if DEBOUNCE > 0
+
+// Number of bit-planes required to hold DEBOUNCE
+#    if DEBOUNCE < 2
+#        define DEBOUNCE_PLANES 1
+#    elif DEBOUNCE < 4
+#        define DEBOUNCE_PLANES 2
+#    elif DEBOUNCE < 8
+#        define DEBOUNCE_PLANES 3
+#    elif DEBOUNCE < 16
+#        define DEBOUNCE_PLANES 4
+#    elif DEBOUNCE < 32
+#        define DEBOUNCE_PLANES 5
+#    elif DEBOUNCE < 64
+#        define DEBOUNCE_PLANES 6
+#    elif DEBOUNCE < 128
+#        define DEBOUNCE_PLANES 7
+#    else
+#        define DEBOUNCE_PLANES 8
+#    endif
+
+// A counter of zero means the key is not being debounced
+static matrix_row_t debounce_planes[MATRIX_ROWS][DEBOUNCE_PLANES];
+static fast_timer_t last_time;
+static bool         counters_need_update;
+static bool         cooked_changed;
+
+static void update_debounce_counters_and_transfer_if_expired(matrix_row_t raw[], matrix_row_t cooked[], uint8_t num_rows, uint8_t elapsed_time);
+static void start_debounce_counters(matrix_row_t raw[], matrix_row_t cooked[], uint8_t num_rows);
+
+// we use num_rows rather than MATRIX_ROWS to support split keyboards
+void debounce_init(uint8_t num_rows) {
+    memset(debounce_planes, 0, sizeof(debounce_planes));
+    counters_need_update = false;
+}
+
+void debounce_free(void) {}
+
+bool debounce(matrix_row_t raw[], matrix_row_t cooked[], uint8_t num_rows, bool changed) {
+    bool updated_last = false;
+    cooked_changed    = false;
+
+    if (counters_need_update) {
+        fast_timer_t now          = timer_read_fast();
+        fast_timer_t elapsed_time = TIMER_DIFF_FAST(now, last_time);
+
+        last_time    = now;
+        updated_last = true;
+        if (elapsed_time > UINT8_MAX) {
+            elapsed_time = UINT8_MAX;
+        }
+
+        if (elapsed_time > 0) {
+            update_debounce_counters_and_transfer_if_expired(raw, cooked, num_rows, elapsed_time);
+        }
+    }
+
+    if (changed) {
+        if (!updated_last) {
+            last_time = timer_read_fast();
+        }
+
+        start_debounce_counters(raw, cooked, num_rows);
+    }
+
+    return cooked_changed;
+}
+
+static void update_debounce_counters_and_transfer_if_expired(matrix_row_t raw[], matrix_row_t cooked[], uint8_t num_rows, uint8_t elapsed_time) {
+    counters_need_update = false;
+    for (uint8_t row = 0; row < num_rows; row++) {
+        matrix_row_t *planes = debounce_planes[row];
+
+        matrix_row_t active = 0;
+        for (uint8_t i = 0; i < DEBOUNCE_PLANES; i++) {
+            active |= planes[i];
+        }
+        if (!active) {
+            continue;
+        }
+
+        // Ripple-borrow subtraction of elapsed_time from every counter at once
+        matrix_row_t borrow    = 0;
+        matrix_row_t remaining = 0;
+        matrix_row_t diff[DEBOUNCE_PLANES];
+        for (uint8_t i = 0; i < DEBOUNCE_PLANES; i++) {
+            matrix_row_t subtrahend = (elapsed_time & (1 << i)) ? ~(matrix_row_t)0 : 0;
+            diff[i]                 = planes[i] ^ subtrahend ^ borrow;
+            borrow                  = (~planes[i] & (subtrahend | borrow)) | (subtrahend & borrow);
+            remaining |= diff[i];
+        }
+        // Anything left of elapsed_time beyond the top plane also underflows
+        if (elapsed_time >> DEBOUNCE_PLANES) {
+            borrow = ~(matrix_row_t)0;
+        }
+
+        matrix_row_t expired = active & (borrow | ~remaining);
+        matrix_row_t pending = active & ~expired;
+        for (uint8_t i = 0; i < DEBOUNCE_PLANES; i++) {
+            planes[i] = diff[i] & pending;
+        }
+
+        if (expired) {
+            matrix_row_t cooked_next = (cooked[row] & ~expired) | (raw[row] & expired);
+            cooked_changed |= cooked[row] ^ cooked_next;
+            cooked[row] = cooked_next;
+        }
+        if (pending) {
+            counters_need_update = true;
+        }
+    }
+}
+
+static void start_debounce_counters(matrix_row_t raw[], matrix_row_t cooked[], uint8_t num_rows) {
+    for (uint8_t row = 0; row < num_rows; row++) {
+        matrix_row_t *planes = debounce_planes[row];
+        matrix_row_t  delta  = raw[row] ^ cooked[row];
+
+        matrix_row_t active = 0;
+        for (uint8_t i = 0; i < DEBOUNCE_PLANES; i++) {
+            // Keys that are back to their debounced state stop being debounced
+            planes[i] &= delta;
+            active |= planes[i];
+        }
+
+        // Keys that have just started changing get a fresh counter
+        matrix_row_t start = delta & ~active;
+        if (start) {
+            for (uint8_t i = 0; i < DEBOUNCE_PLANES; i++) {
+                if (DEBOUNCE & (1 << i)) {
+                    planes[i] |= start;
+                }
+            }
+            counters_need_update = true;
+        }
+    }
+}
+
+#else
+#    include "none.c"
+#endif
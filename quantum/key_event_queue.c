@@ -0,0 +1,121 @@
+// Copyright 2024 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "key_event_queue.h"
+
+#ifdef KEY_EVENT_QUEUE_THREAD
+#    ifndef PROTOCOL_CHIBIOS
+#        error KEY_EVENT_QUEUE_THREAD is only supported on ChibiOS
+#    endif
+#    ifdef SPLIT_KEYBOARD
+#        error KEY_EVENT_QUEUE_THREAD cannot be used on split keyboards, as matrix_scan() also drives the split transport
+#    endif
+#    include <ch.h>
+#    ifndef KEY_EVENT_QUEUE_THREAD_STACK_SIZE
+#        define KEY_EVENT_QUEUE_THREAD_STACK_SIZE 512
+#    endif
+#    ifndef KEY_EVENT_QUEUE_THREAD_PRIORITY
+#        define KEY_EVENT_QUEUE_THREAD_PRIORITY (NORMALPRIO + 1)
+#    endif
+#endif
+
+static keyevent_t key_event_queue[KEY_EVENT_QUEUE_SIZE];
+
+// Only written by the producer
+static uint8_t  key_event_queue_head       = 0;
+static uint16_t key_event_queue_overflowed = 0;
+// Only written by the consumer
+static uint8_t key_event_queue_tail = 0;
+
+bool key_event_queue_push(keyevent_t event) {
+    uint8_t head = __atomic_load_n(&key_event_queue_head, __ATOMIC_RELAXED);
+    uint8_t next = (head + 1) % KEY_EVENT_QUEUE_SIZE;
+
+    if (next == __atomic_load_n(&key_event_queue_tail, __ATOMIC_ACQUIRE)) {
+        __atomic_store_n(&key_event_queue_overflowed, key_event_queue_overflowed + 1, __ATOMIC_RELAXED);
+        return false;
+    }
+
+    key_event_queue[head] = event;
+    // Publish the event only once it has been completely written
+    __atomic_store_n(&key_event_queue_head, next, __ATOMIC_RELEASE);
+    return true;
+}
+
+bool key_event_queue_pop(keyevent_t *event) {
+    uint8_t tail = __atomic_load_n(&key_event_queue_tail, __ATOMIC_RELAXED);
+
+    if (tail == __atomic_load_n(&key_event_queue_head, __ATOMIC_ACQUIRE)) {
+        return false;
+    }
+
+    *event = key_event_queue[tail];
+    // Hand the slot back only once the event has been completely read
+    __atomic_store_n(&key_event_queue_tail, (tail + 1) % KEY_EVENT_QUEUE_SIZE, __ATOMIC_RELEASE);
+    return true;
+}
+
+uint8_t key_event_queue_count(void) {
+    uint8_t head = __atomic_load_n(&key_event_queue_head, __ATOMIC_ACQUIRE);
+    uint8_t tail = __atomic_load_n(&key_event_queue_tail, __ATOMIC_ACQUIRE);
+    return (head + KEY_EVENT_QUEUE_SIZE - tail) % KEY_EVENT_QUEUE_SIZE;
+}
+
+uint16_t key_event_queue_overflows(void) {
+    return __atomic_load_n(&key_event_queue_overflowed, __ATOMIC_RELAXED);
+}
+
+#ifdef KEY_EVENT_QUEUE_THREAD
+static THD_WORKING_AREA(key_event_queue_thread_wa, KEY_EVENT_QUEUE_THREAD_STACK_SIZE);
+
+// Held by the scanner thread for each scan, and by the main loop while paused
+static MUTEX_DECL(key_event_queue_scan_lock);
+// Only accessed with key_event_queue_scan_lock held
+static bool key_event_queue_paused  = false;
+static bool key_event_queue_resumed = false;
+
+static THD_FUNCTION(key_event_queue_thread, arg) {
+    (void)arg;
+    chRegSetThreadName("matrix_scan");
+
+    systime_t next = chVTGetSystemTime();
+    while (true) {
+        chMtxLock(&key_event_queue_scan_lock);
+        if (key_event_queue_resumed) {
+            // The schedule fell behind while paused, restart it instead of catching up
+            key_event_queue_resumed = false;
+            next                    = chVTGetSystemTime();
+        }
+        key_event_queue_scan();
+        chMtxUnlock(&key_event_queue_scan_lock);
+
+        next = chThdSleepUntilWindowed(next, chTimeAddX(next, TIME_US2I(KEY_EVENT_QUEUE_SCAN_INTERVAL_US)));
+    }
+}
+#endif
+
+void key_event_queue_pause(void) {
+#ifdef KEY_EVENT_QUEUE_THREAD
+    if (!key_event_queue_paused) {
+        // Waits for a scan in progress to complete
+        chMtxLock(&key_event_queue_scan_lock);
+        key_event_queue_paused = true;
+    }
+#endif
+}
+
+void key_event_queue_resume(void) {
+#ifdef KEY_EVENT_QUEUE_THREAD
+    if (key_event_queue_paused) {
+        key_event_queue_paused  = false;
+        key_event_queue_resumed = true;
+        chMtxUnlock(&key_event_queue_scan_lock);
+    }
+#endif
+}
+
+void key_event_queue_init(void) {
+#ifdef KEY_EVENT_QUEUE_THREAD
+    chThdCreateStatic(key_event_queue_thread_wa, sizeof(key_event_queue_thread_wa), KEY_EVENT_QUEUE_THREAD_PRIORITY, key_event_queue_thread, NULL);
+#endif
+}
@@ -0,0 +1,102 @@
+// Copyright 2024 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "keyboard.h"
+
+/*
+    A lock-free single-producer, single-consumer queue of key events, which
+    decouples matrix scanning from action processing.
+
+    The producer, key_event_queue_scan(), scans the matrix and queues an event
+    timestamped at scan time for every key that changed state. The consumer,
+    matrix_task(), drains the queue and feeds the events to action_exec(). A
+    slow process_record_*() chain therefore no longer delays the next scan, and
+    tapping decisions are based on when a key was physically pressed.
+
+    Each side only ever writes its own index, so the producer may run in a
+    different context than the consumer, such as a dedicated ChibiOS thread
+    (see KEY_EVENT_QUEUE_THREAD), as long as there is only one producer.
+*/
+
+#ifndef KEY_EVENT_QUEUE_SIZE
+#    define KEY_EVENT_QUEUE_SIZE 32
+#endif
+
+#if KEY_EVENT_QUEUE_SIZE < 2 || KEY_EVENT_QUEUE_SIZE > 256
+#    error KEY_EVENT_QUEUE_SIZE must be between 2 and 256
+#endif
+
+#ifndef KEY_EVENT_QUEUE_SCAN_INTERVAL_US
+#    define KEY_EVENT_QUEUE_SCAN_INTERVAL_US 250
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Starts the scanner thread, if KEY_EVENT_QUEUE_THREAD is defined.
+ */
+void key_event_queue_init(void);
+
+/**
+ * @brief Stops the scanner thread, if KEY_EVENT_QUEUE_THREAD is defined, once
+ * its current scan completes.
+ *
+ * While paused, the caller owns the matrix and may call matrix_scan() itself,
+ * as suspend_wakeup_condition() does while USB is suspended. Must only be
+ * called from the main loop, and does nothing if already paused.
+ */
+void key_event_queue_pause(void);
+
+/**
+ * @brief Restarts the scanner thread stopped by key_event_queue_pause().
+ *
+ * Keys that changed state while paused are queued by the next scan.
+ */
+void key_event_queue_resume(void);
+
+/**
+ * @brief Scans the matrix and queues an event for every key that changed state.
+ *
+ * Keys whose event does not fit in the queue are left unacknowledged, and are
+ * queued again by a later scan.
+ *
+ * @return true Matrix did change
+ * @return false Matrix didn't change
+ */
+bool key_event_queue_scan(void);
+
+/**
+ * @brief Adds an event to the queue. Must only be called by the producer.
+ *
+ * @return false if the queue was full, in which case the overflow counter is
+ * incremented.
+ */
+bool key_event_queue_push(keyevent_t event);
+
+/**
+ * @brief Removes the oldest event from the queue. Must only be called by the
+ * consumer.
+ *
+ * @return false if the queue was empty.
+ */
+bool key_event_queue_pop(keyevent_t *event);
+
+/**
+ * @brief Returns the number of events waiting in the queue.
+ */
+uint8_t key_event_queue_count(void);
+
+/**
+ * @brief Returns the number of events which did not fit in the queue.
+ */
+uint16_t key_event_queue_overflows(void);
+
+#ifdef __cplusplus
+}
+#endif
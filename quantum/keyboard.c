@@ -32,6 +32,7 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include "sendchar.h"
 #include "eeconfig.h"
 #include "action_layer.h"
+#include "task_profiling.h"
 #ifdef BOOTMAGIC_ENABLE
 #    include "bootmagic.h"
 #endif
@@ -140,6 +141,9 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #ifdef OS_DETECTION_ENABLE
 #    include "os_detection.h"
 #endif
+#ifdef KEY_EVENT_QUEUE_ENABLE
+#    include "key_event_queue.h"
+#endif
 
 static uint32_t last_input_modification_time = 0;
 uint32_t        last_input_activity_time(void) {
@@ -371,8 +375,10 @@ __attribute__((weak)) void housekeeping_task_user(void) {}
  * Invokes hooks for executing code after QMK is done after each loop iteration.
  */
 void housekeeping_task(void) {
-    housekeeping_task_kb();
-    housekeeping_task_user();
+    TASK_PROFILE(HOUSEKEEPING_TASK, {
+        housekeeping_task_kb();
+        housekeeping_task_user();
+    });
 }
 
 /** \brief quantum_init
@@ -485,6 +491,9 @@ void keyboard_init(void) {
 #ifdef HAPTIC_ENABLE
     haptic_init();
 #endif
+#ifdef KEY_EVENT_QUEUE_ENABLE
+    key_event_queue_init();
+#endif
 
 #if defined(DEBUG_MATRIX_SCAN_RATE) && defined(CONSOLE_ENABLE)
     debug_enable = true;
@@ -520,6 +529,75 @@ static inline void generate_tick_event(void) {
     }
 }
 
+#ifdef KEY_EVENT_QUEUE_ENABLE
+bool key_event_queue_scan(void) {
+    if (!matrix_can_read()) {
+        return false;
+    }
+
+    static matrix_row_t matrix_previous[MATRIX_ROWS];
+
+    matrix_scan();
+    matrix_scan_perf_task();
+
+    bool matrix_changed = false;
+    for (uint8_t row = 0; row < MATRIX_ROWS; row++) {
+        const matrix_row_t current_row = matrix_get_row(row);
+        const matrix_row_t row_changes = current_row ^ matrix_previous[row];
+
+        if (!row_changes || has_ghost_in_row(row, current_row)) {
+            continue;
+        }
+        matrix_changed = true;
+
+        matrix_row_t col_mask = 1;
+        for (uint8_t col = 0; col < MATRIX_COLS; col++, col_mask <<= 1) {
+            // Only acknowledge the change once it is queued, otherwise retry on the next scan
+            if ((row_changes & col_mask) && key_event_queue_push(MAKE_KEYEVENT(row, col, current_row & col_mask))) {
+                matrix_previous[row] ^= col_mask;
+            }
+        }
+    }
+
+    return matrix_changed;
+}
+
+/**
+ * @brief This task processes the key events queued by key_event_queue_scan(),
+ * scanning the matrix first unless that happens in a separate thread.
+ *
+ * @return true Matrix did change
+ * @return false Matrix didn't change
+ */
+static bool matrix_task(void) {
+#    ifndef KEY_EVENT_QUEUE_THREAD
+    key_event_queue_scan();
+#    endif
+
+    const bool process_keypress = should_process_keypress();
+    bool       matrix_changed   = false;
+    keyevent_t event;
+
+    while (key_event_queue_pop(&event)) {
+        matrix_changed = true;
+
+        if (process_keypress) {
+            action_exec(event);
+        }
+
+        switch_events(event.key.row, event.key.col, event.pressed);
+    }
+
+    if (!matrix_changed) {
+        generate_tick_event();
+    } else if (debug_config.matrix) {
+        // With KEY_EVENT_QUEUE_THREAD this may print a scan in progress, see the docs
+        matrix_print();
+    }
+
+    return matrix_changed;
+}
+#else
 /**
  * @brief This task scans the keyboards matrix and processes any key presses
  * that occur.
@@ -581,6 +659,7 @@ static bool matrix_task(void) {
 
     return matrix_changed;
 }
+#endif
 
 /** \brief Tasks previously located in matrix_scan_quantum
  *
@@ -613,97 +692,106 @@ void quantum_task(void) {
 #endif
 
 #if defined(AUDIO_ENABLE) && !defined(NO_MUSIC_MODE)
-    music_task();
+    TASK_PROFILE(MUSIC_TASK, music_task());
 #endif
 
 #ifdef KEY_OVERRIDE_ENABLE
-    key_override_task();
+    TASK_PROFILE(KEY_OVERRIDE_TASK, key_override_task());
 #endif
 
 #ifdef SEQUENCER_ENABLE
-    sequencer_task();
+    TASK_PROFILE(SEQUENCER_TASK, sequencer_task());
 #endif
 
 #ifdef TAP_DANCE_ENABLE
-    tap_dance_task();
+    TASK_PROFILE(TAP_DANCE_TASK, tap_dance_task());
 #endif
 
 #ifdef COMBO_ENABLE
-    combo_task();
+    TASK_PROFILE(COMBO_TASK, combo_task());
 #endif
 
 #ifdef LEADER_ENABLE
-    leader_task();
+    TASK_PROFILE(LEADER_TASK, leader_task());
 #endif
 
 #ifdef WPM_ENABLE
-    decay_wpm();
+    TASK_PROFILE(DECAY_WPM, decay_wpm());
 #endif
 
 #ifdef DIP_SWITCH_ENABLE
-    dip_switch_task();
+    TASK_PROFILE(DIP_SWITCH_TASK, dip_switch_task());
 #endif
 
 #ifdef AUTO_SHIFT_ENABLE
-    autoshift_matrix_scan();
+    TASK_PROFILE(AUTOSHIFT_MATRIX_SCAN, autoshift_matrix_scan());
 #endif
 
 #ifdef CAPS_WORD_ENABLE
-    caps_word_task();
+    TASK_PROFILE(CAPS_WORD_TASK, caps_word_task());
 #endif
 
 #ifdef SECURE_ENABLE
-    secure_task();
+    TASK_PROFILE(SECURE_TASK, secure_task());
 #endif
 }
 
 /** \brief Main task that is repeatedly called as fast as possible. */
 void keyboard_task(void) {
+#ifdef TASK_PROFILING_ENABLE
+    const uint32_t keyboard_task_start = cycle_counter_read();
+#endif
     __attribute__((unused)) bool activity_has_occurred = false;
-    if (matrix_task()) {
+    bool                         matrix_changed;
+    TASK_PROFILE(MATRIX_TASK, matrix_changed = matrix_task());
+    if (matrix_changed) {
         last_matrix_activity_trigger();
         activity_has_occurred = true;
     }
 
-    quantum_task();
+    TASK_PROFILE(QUANTUM_TASK, quantum_task());
 
 #if defined(SPLIT_WATCHDOG_ENABLE)
-    split_watchdog_task();
+    TASK_PROFILE(SPLIT_WATCHDOG_TASK, split_watchdog_task());
 #endif
 
 #if defined(RGBLIGHT_ENABLE)
-    rgblight_task();
+    TASK_PROFILE(RGBLIGHT_TASK, rgblight_task());
 #endif
 
 #ifdef LED_MATRIX_ENABLE
-    led_matrix_task();
+    TASK_PROFILE(LED_MATRIX_TASK, led_matrix_task());
 #endif
 #ifdef RGB_MATRIX_ENABLE
-    rgb_matrix_task();
+    TASK_PROFILE(RGB_MATRIX_TASK, rgb_matrix_task());
 #endif
 
 #if defined(BACKLIGHT_ENABLE)
 #    if defined(BACKLIGHT_PIN) || defined(BACKLIGHT_PINS)
-    backlight_task();
+    TASK_PROFILE(BACKLIGHT_TASK, backlight_task());
 #    endif
 #endif
 
 #ifdef ENCODER_ENABLE
-    if (encoder_task()) {
+    bool encoder_changed;
+    TASK_PROFILE(ENCODER_TASK, encoder_changed = encoder_task());
+    if (encoder_changed) {
         last_encoder_activity_trigger();
         activity_has_occurred = true;
     }
 #endif
 
 #ifdef POINTING_DEVICE_ENABLE
-    if (pointing_device_task()) {
+    bool pointing_device_changed;
+    TASK_PROFILE(POINTING_DEVICE_TASK, pointing_device_changed = pointing_device_task());
+    if (pointing_device_changed) {
         last_pointing_device_activity_trigger();
         activity_has_occurred = true;
     }
 #endif
 
 #ifdef OLED_ENABLE
-    oled_task();
+    TASK_PROFILE(OLED_TASK, oled_task());
 #    if OLED_TIMEOUT > 0
     // Wake up oled if user is using those fabulous keys or spinning those encoders!
     if (activity_has_occurred) oled_on();
@@ -711,7 +799,7 @@ void keyboard_task(void) {
 #endif
 
 #ifdef ST7565_ENABLE
-    st7565_task();
+    TASK_PROFILE(ST7565_TASK, st7565_task());
 #    if ST7565_TIMEOUT > 0
     // Wake up display if user is using those fabulous keys or spinning those encoders!
     if (activity_has_occurred) st7565_on();
@@ -720,32 +808,37 @@ void keyboard_task(void) {
 
 #ifdef MOUSEKEY_ENABLE
     // mousekey repeat & acceleration
-    mousekey_task();
+    TASK_PROFILE(MOUSEKEY_TASK, mousekey_task());
 #endif
 
 #ifdef PS2_MOUSE_ENABLE
-    ps2_mouse_task();
+    TASK_PROFILE(PS2_MOUSE_TASK, ps2_mouse_task());
 #endif
 
 #ifdef MIDI_ENABLE
-    midi_task();
+    TASK_PROFILE(MIDI_TASK, midi_task());
 #endif
 
 #ifdef JOYSTICK_ENABLE
-    joystick_task();
+    TASK_PROFILE(JOYSTICK_TASK, joystick_task());
 #endif
 
 #ifdef BLUETOOTH_ENABLE
-    bluetooth_task();
+    TASK_PROFILE(BLUETOOTH_TASK, bluetooth_task());
 #endif
 
 #ifdef HAPTIC_ENABLE
-    haptic_task();
+    TASK_PROFILE(HAPTIC_TASK, haptic_task());
 #endif
 
-    led_task();
+    TASK_PROFILE(LED_TASK, led_task());
 
 #ifdef OS_DETECTION_ENABLE
-    os_detection_task();
+    TASK_PROFILE(OS_DETECTION_TASK, os_detection_task());
+#endif
+
+#ifdef TASK_PROFILING_ENABLE
+    task_profiling_record(TASK_PROFILE_ID_KEYBOARD_TASK, cycle_counter_read() - keyboard_task_start);
+    task_profiling_task();
 #endif
 }
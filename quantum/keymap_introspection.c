@@ -108,4 +108,12 @@ __attribute__((weak)) combo_t* combo_get(uint16_t combo_idx) {
     return combo_get_raw(combo_idx);
 }
 
+#    ifdef COMBO_INDEX
+static uint8_t combo_index_bitmaps[COMBO_INDEX_BITMAP_COUNT][(sizeof(key_combos) / sizeof(combo_t) + 7) / 8];
+
+uint8_t* combo_index_bitmap_raw(uint8_t bitmap) {
+    return combo_index_bitmaps[bitmap];
+}
+#    endif
+
 #endif // defined(COMBO_ENABLE)
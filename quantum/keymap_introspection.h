@@ -66,4 +66,9 @@ combo_t* combo_get_raw(uint16_t combo_idx);
 // Get the keycode for the encoder mapping location, potentially stored dynamically
 combo_t* combo_get(uint16_t combo_idx);
 
+#    ifdef COMBO_INDEX
+// Get one of the combo index bitmaps, each holding one bit per combo stored in firmware
+uint8_t* combo_index_bitmap_raw(uint8_t bitmap);
+#    endif
+
 #endif // defined(COMBO_ENABLE)
@@ -0,0 +1,104 @@
+// Copyright 2024 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include <stdint.h>
+
+/* Fixed point kinematics shared by mousekeys and cursor glide.
+ *
+ * Velocities are in units per millisecond, and decelerations in units per
+ * millisecond per millisecond, both in Q16. Axes are moved by the time that
+ * has actually elapsed rather than by fixed ticks, so that speeds do not
+ * depend on how often they are moved, and the fraction of a unit that has not
+ * been reported yet is carried over to the next move.
+ *
+ * Time deltas are at most 255 ms, and velocities are limited so that moving
+ * for that long still fits in 32 bits, which keeps the maths cheap on AVR.
+ * The limit, KINEMATICS_VELOCITY_MAX, is 128 units per ms: a hi-res wheel
+ * with a multiplier of 120 cannot scroll faster than about a detent per ms.
+ */
+typedef int32_t q16_t;
+
+#define Q16_ONE ((q16_t)1 << 16)
+#define KINEMATICS_VELOCITY_MAX (INT32_MAX / 256)
+#define KINEMATICS_DECEL_MAX (KINEMATICS_VELOCITY_MAX / 256)
+
+typedef struct {
+    q16_t velocity;
+    q16_t remainder; // moved but not reported yet, less than a unit
+} kinematics_axis_t;
+
+static inline q16_t kinematics_clamp_velocity(q16_t velocity) {
+    return velocity > KINEMATICS_VELOCITY_MAX ? KINEMATICS_VELOCITY_MAX : velocity < -KINEMATICS_VELOCITY_MAX ? -KINEMATICS_VELOCITY_MAX : velocity;
+}
+
+/* Returns the velocity of moving the given units every interval ms, rounded
+ * away from zero so that moving for the interval gives all of them */
+static inline q16_t kinematics_rate(int16_t units, uint16_t interval) {
+    q16_t distance = units * Q16_ONE;
+
+    if (interval < 1) interval = 1;
+    return kinematics_clamp_velocity((distance + (distance < 0 ? 1 - interval : interval - 1)) / interval);
+}
+
+// Adds distance to what has not been reported yet, and takes the whole units out of it
+static inline int16_t kinematics_take(q16_t *remainder, q16_t distance) {
+    q16_t   total = *remainder + distance;
+    int16_t units = total / Q16_ONE;
+
+    *remainder = total - units * Q16_ONE;
+    return units;
+}
+
+// Moves the axis at its velocity for dt ms, and returns the whole units moved
+static inline int16_t kinematics_move(kinematics_axis_t *axis, uint8_t dt) {
+    return kinematics_take(&axis->remainder, axis->velocity * dt);
+}
+
+/* Slows velocity down by decel per ms for dt ms, down to a stop, and returns
+ * the distance covered. decel must be at most KINEMATICS_DECEL_MAX.
+ */
+static inline q16_t kinematics_brake_distance(q16_t *velocity, q16_t decel, uint8_t dt) {
+    q16_t v0     = *velocity;
+    q16_t change = decel * dt;
+
+    if (v0 > change) {
+        *velocity = v0 - change;
+    } else if (v0 < -change) {
+        *velocity = v0 + change;
+    } else {
+        // stops within dt, after v0 / decel ms, worked out in Q8 so as not to overflow
+        q16_t stop = decel ? (v0 < 0 ? -v0 : v0) * 256 / decel : 0;
+        *velocity  = 0;
+        return v0 / 256 * stop / 2;
+    }
+    return (v0 + *velocity) / 2 * dt;
+}
+
+// Slows the axis down by decel per ms for dt ms, and returns the whole units moved
+static inline int16_t kinematics_brake(kinematics_axis_t *axis, q16_t decel, uint8_t dt) {
+    return kinematics_take(&axis->remainder, kinematics_brake_distance(&axis->velocity, decel, dt));
+}
+
+static inline void kinematics_stop(kinematics_axis_t *axis) {
+    axis->velocity  = 0;
+    axis->remainder = 0;
+}
+
+// Returns the length of (x, y), rounded down
+static inline uint16_t kinematics_hypot(int16_t x, int16_t y) {
+    uint32_t square = (uint32_t)((int32_t)x * x) + (uint32_t)((int32_t)y * y);
+    uint32_t l = 0, h = UINT16_MAX + 1UL;
+
+    // binary search for the integer square root
+    while (l != h - 1) {
+        uint32_t m = (l + h) / 2;
+        if (m * m <= square) {
+            l = m;
+        } else {
+            h = m;
+        }
+    }
+    return l;
+}
@@ -30,6 +30,9 @@
 #include "led_tables.h"
 
 #include <lib/lib8tion/lib8tion.h>
+#ifdef LED_MATRIX_RENDER_BUDGET_US
+#    include "render_budget.h"
+#endif
 
 #ifndef LED_MATRIX_CENTER
 const led_point_t k_led_matrix_center = {112, 32};
@@ -74,6 +77,10 @@ static uint8_t         led_last_enable   = UINT8_MAX;
 static uint8_t         led_last_effect   = UINT8_MAX;
 static effect_params_t led_effect_params = {0, LED_FLAG_ALL, false};
 static led_task_states led_task_state    = SYNCING;
+#ifdef LED_MATRIX_RENDER_BUDGET_US
+static render_budget_t            led_render_budget;
+static struct led_matrix_limits_t led_render_slice;
+#endif // LED_MATRIX_RENDER_BUDGET_US
 
 // double buffers
 static uint32_t led_timer_buffer;
@@ -239,6 +246,9 @@ static void led_task_sync(void) {
 static void led_task_start(void) {
     // reset iter
     led_effect_params.iter = 0;
+#ifdef LED_MATRIX_RENDER_BUDGET_US
+    led_render_slice.led_max_index = 0;
+#endif // LED_MATRIX_RENDER_BUDGET_US
 
     // update double buffers
     g_led_timer = led_timer_buffer;
@@ -258,6 +268,16 @@ static void led_task_render(uint8_t effect) {
         led_matrix_set_value_all(0);
     }
 
+#ifdef LED_MATRIX_RENDER_BUDGET_US
+    // size the next slice from what the effect has cost so far
+    if (led_effect_params.init && led_effect_params.iter == 0) {
+        render_budget_reset(&led_render_budget);
+    }
+    led_render_slice.led_min_index = led_render_slice.led_max_index;
+    led_render_slice.led_max_index = MIN(led_render_slice.led_min_index + render_budget_slice(&led_render_budget, LED_MATRIX_LED_PROCESS_LIMIT), LED_MATRIX_LED_COUNT);
+    render_budget_begin(&led_render_budget);
+#endif // LED_MATRIX_RENDER_BUDGET_US
+
     // each effect can opt to do calculations
     // and/or request PWM buffer updates.
     switch (effect) {
@@ -291,6 +311,11 @@ static void led_task_render(uint8_t effect) {
             // ---------------------------------------------
     }
 
+#ifdef LED_MATRIX_RENDER_BUDGET_US
+    struct led_matrix_limits_t limits = led_matrix_get_limits(led_effect_params.iter);
+    render_budget_end(&led_render_budget, limits.led_max_index > limits.led_min_index ? limits.led_max_index - limits.led_min_index : 0);
+#endif // LED_MATRIX_RENDER_BUDGET_US
+
     led_effect_params.iter++;
 
     // next task
@@ -382,7 +407,14 @@ __attribute__((weak)) bool led_matrix_indicators_advanced_user(uint8_t led_min,
 
 struct led_matrix_limits_t led_matrix_get_limits(uint8_t iter) {
     struct led_matrix_limits_t limits = {0};
-#if defined(LED_MATRIX_LED_PROCESS_LIMIT) && LED_MATRIX_LED_PROCESS_LIMIT > 0 && LED_MATRIX_LED_PROCESS_LIMIT < LED_MATRIX_LED_COUNT
+#if defined(LED_MATRIX_RENDER_BUDGET_US)
+    limits = led_render_slice;
+#    if defined(LED_MATRIX_SPLIT)
+    uint8_t k_led_matrix_split[2] = LED_MATRIX_SPLIT;
+    if (is_keyboard_left() && (limits.led_max_index > k_led_matrix_split[0])) limits.led_max_index = k_led_matrix_split[0];
+    if (!(is_keyboard_left()) && (limits.led_min_index < k_led_matrix_split[0])) limits.led_min_index = k_led_matrix_split[0];
+#    endif
+#elif defined(LED_MATRIX_LED_PROCESS_LIMIT) && LED_MATRIX_LED_PROCESS_LIMIT > 0 && LED_MATRIX_LED_PROCESS_LIMIT < LED_MATRIX_LED_COUNT
 #    if defined(LED_MATRIX_SPLIT)
     limits.led_min_index = LED_MATRIX_LED_PROCESS_LIMIT * (iter);
     limits.led_max_index = limits.led_min_index + LED_MATRIX_LED_PROCESS_LIMIT;
@@ -413,6 +445,10 @@ struct led_matrix_limits_t led_matrix_get_limits(uint8_t iter) {
 void led_matrix_init(void) {
     led_matrix_driver.init();
 
+#ifdef LED_MATRIX_RENDER_BUDGET_US
+    render_budget_init(&led_render_budget, LED_MATRIX_RENDER_BUDGET_US);
+#endif // LED_MATRIX_RENDER_BUDGET_US
+
 #ifdef LED_MATRIX_KEYREACTIVE_ENABLED
     g_last_hit_tracker.count = 0;
     for (uint8_t i = 0; i < LED_HITS_TO_REMEMBER; ++i) {
@@ -312,6 +312,167 @@ void matrix_init(void) {
     matrix_init_kb();
 }
 
+#ifdef MATRIX_INTERRUPT_WAKE
+/*
+ * Interrupt wake scanning
+ *
+ * Once every key is released and debouncing has settled, all outputs are
+ * driven active at once and an edge interrupt is armed on every input. Until
+ * one of them fires, matrix_scan() skips reading the matrix entirely -- a
+ * press on any key pulls its input line and wakes the scanner back up, after
+ * which normal scanning resumes until the matrix is idle again.
+ */
+static volatile bool matrix_wake_pending = true;
+static bool          matrix_wake_armed   = false;
+
+/** \brief Signals that an input changed while the matrix was idle
+ *
+ * Safe to call from interrupt context.
+ */
+void matrix_wake_signal(void) {
+    matrix_wake_pending = true;
+}
+
+#    if defined(DIRECT_PINS)
+#        define MATRIX_WAKE_INPUT_COUNT (ROWS_PER_HAND * MATRIX_COLS)
+#        define MATRIX_WAKE_INPUT(i) (direct_pins[(i) / MATRIX_COLS][(i) % MATRIX_COLS])
+#    elif (DIODE_DIRECTION == COL2ROW)
+#        define MATRIX_WAKE_INPUT_COUNT (MATRIX_COLS)
+#        define MATRIX_WAKE_INPUT(i) (col_pins[i])
+#    elif (DIODE_DIRECTION == ROW2COL)
+#        define MATRIX_WAKE_INPUT_COUNT (ROWS_PER_HAND)
+#        define MATRIX_WAKE_INPUT(i) (row_pins[i])
+#    endif
+
+static void matrix_wake_select_all(void) {
+#    if !defined(DIRECT_PINS) && (DIODE_DIRECTION == COL2ROW)
+    for (uint8_t row = 0; row < ROWS_PER_HAND; row++) {
+        select_row(row);
+    }
+#    elif !defined(DIRECT_PINS) && (DIODE_DIRECTION == ROW2COL)
+    for (uint8_t col = 0; col < MATRIX_COLS; col++) {
+        select_col(col);
+    }
+#    endif
+    matrix_output_select_delay();
+}
+
+static void matrix_wake_unselect_all(void) {
+#    if !defined(DIRECT_PINS) && (DIODE_DIRECTION == COL2ROW)
+    unselect_rows();
+#    elif !defined(DIRECT_PINS) && (DIODE_DIRECTION == ROW2COL)
+    unselect_cols();
+#    endif
+}
+
+static bool matrix_wake_any_input_active(void) {
+    for (uint8_t i = 0; i < MATRIX_WAKE_INPUT_COUNT; i++) {
+        pin_t pin = MATRIX_WAKE_INPUT(i);
+        if (pin != NO_PIN && readMatrixPin(pin) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+#    if defined(PROTOCOL_CHIBIOS)
+#        if !defined(PAL_USE_CALLBACKS) || PAL_USE_CALLBACKS != TRUE
+#            error MATRIX_INTERRUPT_WAKE requires PAL_USE_CALLBACKS to be enabled in halconf.h
+#        endif
+
+static void matrix_wake_callback(void *arg) {
+    matrix_wake_signal();
+}
+
+__attribute__((weak)) void matrix_wake_arm(pin_t pin) {
+    palEnableLineEvent(pin, (MATRIX_INPUT_PRESSED_STATE == 0) ? PAL_EVENT_MODE_FALLING_EDGE : PAL_EVENT_MODE_RISING_EDGE);
+    palSetLineCallback(pin, matrix_wake_callback, NULL);
+}
+
+__attribute__((weak)) void matrix_wake_disarm(pin_t pin) {
+    palDisableLineEvent(pin);
+}
+
+__attribute__((weak)) void matrix_wake_sleep(void) {
+#        ifdef MATRIX_INTERRUPT_WAKE_SLEEP
+    // Any interrupt -- matrix wake, USB, systick -- resumes execution
+    __WFI();
+#        endif
+}
+#    else
+__attribute__((weak)) void matrix_wake_sleep(void) {}
+#    endif
+
+static void matrix_wake_enter_idle(void) {
+    matrix_wake_select_all();
+
+    matrix_wake_pending = false;
+    for (uint8_t i = 0; i < MATRIX_WAKE_INPUT_COUNT; i++) {
+        pin_t pin = MATRIX_WAKE_INPUT(i);
+        if (pin != NO_PIN) {
+            matrix_wake_arm(pin);
+        }
+    }
+    matrix_wake_armed = true;
+
+    // Catch any press which landed between the last scan and arming the interrupts
+    if (matrix_wake_any_input_active()) {
+        matrix_wake_signal();
+    }
+}
+
+static void matrix_wake_exit_idle(void) {
+    for (uint8_t i = 0; i < MATRIX_WAKE_INPUT_COUNT; i++) {
+        pin_t pin = MATRIX_WAKE_INPUT(i);
+        if (pin != NO_PIN) {
+            matrix_wake_disarm(pin);
+        }
+    }
+    matrix_wake_armed = false;
+
+    matrix_wake_unselect_all();
+    matrix_output_unselect_delay(0, true);
+}
+
+/**
+ * @brief Determines whether the physical matrix needs to be read this cycle,
+ * leaving idle mode if a wake interrupt has fired.
+ */
+static bool matrix_wake_should_scan(void) {
+    if (!matrix_wake_armed) {
+        return true;
+    }
+    if (!matrix_wake_pending) {
+        matrix_wake_sleep();
+        if (!matrix_wake_pending) {
+            return false;
+        }
+    }
+    matrix_wake_exit_idle();
+    return true;
+}
+
+/**
+ * @brief Arms the wake interrupts once no key is held on this half and
+ * debouncing has settled.
+ */
+static void matrix_wake_update(void) {
+    if (matrix_wake_armed) {
+        return;
+    }
+    for (uint8_t row = 0; row < ROWS_PER_HAND; row++) {
+#    ifdef SPLIT_KEYBOARD
+        if (raw_matrix[row] || matrix[thisHand + row]) {
+#    else
+        if (raw_matrix[row] || matrix[row]) {
+#    endif
+            return;
+        }
+    }
+    matrix_wake_enter_idle();
+}
+#endif // MATRIX_INTERRUPT_WAKE
+
 #ifdef SPLIT_KEYBOARD
 // Fallback implementation for keyboards not using the standard split_util.c
 __attribute__((weak)) bool transport_master_if_connected(matrix_row_t master_matrix[], matrix_row_t slave_matrix[]) {
@@ -320,9 +481,7 @@ __attribute__((weak)) bool transport_master_if_connected(matrix_row_t master_mat
 }
 #endif
 
-uint8_t matrix_scan(void) {
-    matrix_row_t curr_matrix[MATRIX_ROWS] = {0};
-
+static void matrix_read(matrix_row_t curr_matrix[]) {
 #if defined(DIRECT_PINS) || (DIODE_DIRECTION == COL2ROW)
     // Set row, read cols
     for (uint8_t current_row = 0; current_row < ROWS_PER_HAND; current_row++) {
@@ -335,6 +494,19 @@ uint8_t matrix_scan(void) {
         matrix_read_rows_on_col(curr_matrix, current_col, row_shifter);
     }
 #endif
+}
+
+uint8_t matrix_scan(void) {
+    matrix_row_t curr_matrix[MATRIX_ROWS] = {0};
+
+#ifdef MATRIX_INTERRUPT_WAKE
+    // While idle, nothing is held so an unread matrix is an all-zero matrix
+    if (matrix_wake_should_scan()) {
+        matrix_read(curr_matrix);
+    }
+#else
+    matrix_read(curr_matrix);
+#endif
 
     bool changed = memcmp(raw_matrix, curr_matrix, sizeof(curr_matrix)) != 0;
     if (changed) memcpy(raw_matrix, curr_matrix, sizeof(curr_matrix));
@@ -345,5 +517,9 @@ uint8_t matrix_scan(void) {
     changed = debounce(raw_matrix, matrix, ROWS_PER_HAND, changed);
     matrix_scan_kb();
 #endif
+
+#ifdef MATRIX_INTERRUPT_WAKE
+    matrix_wake_update();
+#endif
     return (uint8_t)changed;
 }
@@ -75,6 +75,14 @@ void matrix_scan_kb(void);
 void matrix_init_user(void);
 void matrix_scan_user(void);
 
+#ifdef MATRIX_INTERRUPT_WAKE
+/* interrupt wake scanning */
+void matrix_wake_signal(void);
+void matrix_wake_arm(pin_t pin);
+void matrix_wake_disarm(pin_t pin);
+void matrix_wake_sleep(void);
+#endif
+
 #ifdef SPLIT_KEYBOARD
 bool matrix_post_scan(void);
 void matrix_slave_scan_kb(void);
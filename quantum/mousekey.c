@@ -22,12 +22,16 @@
 #include "timer.h"
 #include "print.h"
 #include "debug.h"
+#include "util.h"
 #include "mousekey.h"
+#ifndef MK_3_SPEED
+#    include "kinematics.h"
+#endif
 
-static inline int8_t times_inv_sqrt2(int8_t x) {
+static inline int16_t times_inv_sqrt2(int16_t x) {
     // 181/256 (0.70703125) is used as an approximation for 1/sqrt(2)
     // because it is close to the exact value which is 0.707106781
-    const int16_t  n = x * 181;
+    const int32_t  n = (int32_t)x * 181;
     const uint16_t d = 256;
 
     // To ensure that the integer result is rounded accurately after
@@ -58,6 +62,22 @@ static uint16_t mouse_timer = 0;
 static uint16_t last_timer_c = 0;
 static uint16_t last_timer_w = 0;
 
+/* Once repeating, the cursor and wheel move at the speed given by move_unit()
+ * and wheel_unit() per interval, for the time that has actually elapsed, every
+ * MOUSEKEY_REPORT_INTERVAL or interval if shorter. */
+typedef struct {
+    uint16_t timer;   // when the axes last moved
+    uint16_t elapsed; // time into the current interval
+    uint8_t  passed;  // intervals that passed when the axes last moved
+} mousekey_clock_t;
+
+static mousekey_clock_t  mousekey_cursor_clock = {0};
+static mousekey_clock_t  mousekey_wheel_clock  = {0};
+static kinematics_axis_t mousekey_x_axis       = {0};
+static kinematics_axis_t mousekey_y_axis       = {0};
+static kinematics_axis_t mousekey_v_axis       = {0};
+static kinematics_axis_t mousekey_h_axis       = {0};
+
 /*
  * Mouse keys acceleration algorithm
  *  http://en.wikipedia.org/wiki/Mouse_keys
@@ -304,6 +324,52 @@ static int8_t calc_inertia(int8_t direction, int8_t velocity) {
 
 #    endif
 
+// Sets the clock so that the first move is one period long, and ends the first interval
+static void mousekey_clock_start(mousekey_clock_t *clock, uint16_t interval, uint16_t period) {
+    if (period == 0) period = 1;
+    if (interval < period) interval = period;
+    clock->timer   = timer_read() - period;
+    clock->elapsed = interval - period;
+}
+
+/* Moves the clock on to now, counting the intervals that passed, and returns
+ * how long the axes should move for: at most an interval, so that they do not
+ * jump when the task is late. */
+static uint8_t mousekey_clock_tick(mousekey_clock_t *clock, uint16_t interval) {
+    uint16_t dt = timer_elapsed(clock->timer);
+
+    clock->timer += dt;
+    if (interval == 0) interval = 1;
+    if (dt > interval) dt = interval;
+    if (dt > UINT8_MAX) dt = UINT8_MAX;
+
+    clock->passed = 0;
+    for (clock->elapsed += dt; clock->elapsed >= interval; clock->elapsed -= interval) {
+        if (clock->passed != UINT8_MAX) clock->passed++;
+    }
+    return dt;
+}
+
+/* Whether the next move is due, a period after the last one. Moving once per
+ * interval keeps the original cadence of a move every interval + 1 ms. */
+static bool mousekey_clock_due(mousekey_clock_t *clock, uint16_t interval, uint16_t period) {
+    uint16_t elapsed = timer_elapsed(clock->timer);
+
+    return period < interval ? elapsed >= period : elapsed > period;
+}
+
+static uint8_t mousekey_repeat_add(uint8_t repeat, uint8_t passed) {
+    return repeat > UINT8_MAX - passed ? UINT8_MAX : repeat + passed;
+}
+
+// Moves the axis at velocity in the direction of dir for dt, and returns the units to report
+static int16_t mousekey_move(kinematics_axis_t *axis, int16_t dir, q16_t velocity, uint8_t dt, int16_t max) {
+    axis->velocity = dir > 0 ? velocity : dir < 0 ? -velocity : 0;
+
+    int16_t units = kinematics_move(axis, dt);
+    return units > max ? max : units < -max ? -max : units;
+}
+
 void mousekey_task(void) {
     // report cursor and scroll movement independently
     report_mouse_t tmpmr = mouse_report;
@@ -313,21 +379,33 @@ void mousekey_task(void) {
     mouse_report.v = 0;
     mouse_report.h = 0;
 
+    uint16_t period = MIN(MOUSEKEY_REPORT_INTERVAL, mk_interval);
+
 #    ifdef MOUSEKEY_INERTIA
 
     // if an animation is in progress and it's time for the next frame
-    if ((mousekey_frame) && timer_elapsed(last_timer_c) > ((mousekey_frame > 1) ? mk_interval : mk_delay * 10)) {
-        mousekey_x_inertia = calc_inertia(mousekey_x_dir, mousekey_x_inertia);
-        mousekey_y_inertia = calc_inertia(mousekey_y_dir, mousekey_y_inertia);
+    if ((mousekey_frame) && ((mousekey_frame > 1) ? mousekey_clock_due(&mousekey_cursor_clock, mk_interval, period) : timer_elapsed(last_timer_c) > mk_delay * 10)) {
+        if (mousekey_frame < 2) mousekey_clock_start(&mousekey_cursor_clock, mk_interval, period);
+        uint8_t dt = mousekey_clock_tick(&mousekey_cursor_clock, mk_interval);
+
+        // one frame of inertia per interval
+        for (uint8_t i = 0; i < mousekey_cursor_clock.passed; i++) {
+            mousekey_x_inertia = calc_inertia(mousekey_x_dir, mousekey_x_inertia);
+            mousekey_y_inertia = calc_inertia(mousekey_y_dir, mousekey_y_inertia);
+        }
 
-        mouse_report.x = move_unit(0);
-        mouse_report.y = move_unit(1);
+        if (mousekey_frame < 2) {
+            mouse_report.x = move_unit(0);
+            mouse_report.y = move_unit(1);
+            mousekey_frame++;
+        } else {
+            mouse_report.x = mousekey_move(&mousekey_x_axis, 1, kinematics_rate(move_unit(0), mk_interval), dt, MOUSEKEY_MOVE_MAX);
+            mouse_report.y = mousekey_move(&mousekey_y_axis, 1, kinematics_rate(move_unit(1), mk_interval), dt, MOUSEKEY_MOVE_MAX);
+        }
 
         // prevent sticky "drift"
         if ((!mousekey_x_dir) && (!mousekey_x_inertia)) tmpmr.x = 0;
         if ((!mousekey_y_dir) && (!mousekey_y_inertia)) tmpmr.y = 0;
-
-        if (mousekey_frame < 2) mousekey_frame++;
     }
 
     // reset if not moving and no movement keys are held
@@ -335,46 +413,50 @@ void mousekey_task(void) {
         mousekey_frame = 0;
         tmpmr.x        = 0;
         tmpmr.y        = 0;
+        kinematics_stop(&mousekey_x_axis);
+        kinematics_stop(&mousekey_y_axis);
     }
 
 #    else // default acceleration
 
-    if ((tmpmr.x || tmpmr.y) && timer_elapsed(last_timer_c) > (mousekey_repeat ? mk_interval : mk_delay * 10)) {
-        if (mousekey_repeat != UINT8_MAX) mousekey_repeat++;
-        if (tmpmr.x != 0) mouse_report.x = move_unit() * ((tmpmr.x > 0) ? 1 : -1);
-        if (tmpmr.y != 0) mouse_report.y = move_unit() * ((tmpmr.y > 0) ? 1 : -1);
+    if ((tmpmr.x || tmpmr.y) && (mousekey_repeat ? mousekey_clock_due(&mousekey_cursor_clock, mk_interval, period) : timer_elapsed(last_timer_c) > mk_delay * 10)) {
+        if (mousekey_repeat == 0) mousekey_clock_start(&mousekey_cursor_clock, mk_interval, period);
+        uint8_t dt      = mousekey_clock_tick(&mousekey_cursor_clock, mk_interval);
+        mousekey_repeat = mousekey_repeat_add(mousekey_repeat, mousekey_cursor_clock.passed);
 
+        q16_t velocity = kinematics_rate(move_unit(), mk_interval);
         /* diagonal move [1/sqrt(2)] */
-        if (mouse_report.x && mouse_report.y) {
-            mouse_report.x = times_inv_sqrt2(mouse_report.x);
-            if (mouse_report.x == 0) {
-                mouse_report.x = 1;
-            }
-            mouse_report.y = times_inv_sqrt2(mouse_report.y);
-            if (mouse_report.y == 0) {
-                mouse_report.y = 1;
-            }
+        if (tmpmr.x && tmpmr.y) {
+            velocity = velocity * 181 / 256;
         }
+        mouse_report.x = mousekey_move(&mousekey_x_axis, tmpmr.x, velocity, dt, MOUSEKEY_MOVE_MAX);
+        mouse_report.y = mousekey_move(&mousekey_y_axis, tmpmr.y, velocity, dt, MOUSEKEY_MOVE_MAX);
     }
 
 #    endif // MOUSEKEY_INERTIA or not
 
-    if ((tmpmr.v || tmpmr.h) && timer_elapsed(last_timer_w) > (mousekey_wheel_repeat ? mk_wheel_interval : mk_wheel_delay * 10)) {
-        if (mousekey_wheel_repeat != UINT8_MAX) mousekey_wheel_repeat++;
-        if (tmpmr.v != 0) mouse_report.v = wheel_unit() * ((tmpmr.v > 0) ? 1 : -1);
-        if (tmpmr.h != 0) mouse_report.h = wheel_unit() * ((tmpmr.h > 0) ? 1 : -1);
+    // the wheel is sent in steps when it has the resolution for them, or when reports were made more frequent
+#    if defined(MOUSE_HIRES_SCROLL_ENABLE) || MOUSEKEY_REPORT_INTERVAL < MOUSEKEY_INTERVAL
+    uint16_t wheel_period = MIN(period, mk_wheel_interval);
+#    else
+    uint16_t wheel_period = mk_wheel_interval;
+#    endif
+
+    if ((tmpmr.v || tmpmr.h) && (mousekey_wheel_repeat ? mousekey_clock_due(&mousekey_wheel_clock, mk_wheel_interval, wheel_period) : timer_elapsed(last_timer_w) > mk_wheel_delay * 10)) {
+        if (mousekey_wheel_repeat == 0) mousekey_clock_start(&mousekey_wheel_clock, mk_wheel_interval, wheel_period);
+        uint8_t dt            = mousekey_clock_tick(&mousekey_wheel_clock, mk_wheel_interval);
+        mousekey_wheel_repeat = mousekey_repeat_add(mousekey_wheel_repeat, mousekey_wheel_clock.passed);
 
+        uint8_t unit       = wheel_unit(); // updates mk_wheel_interval with MK_KINETIC_SPEED
+        q16_t   velocity_v = kinematics_rate(unit * MOUSE_WHEEL_DETENT_V, mk_wheel_interval);
+        q16_t   velocity_h = kinematics_rate(unit * MOUSE_WHEEL_DETENT_H, mk_wheel_interval);
         /* diagonal move [1/sqrt(2)] */
-        if (mouse_report.v && mouse_report.h) {
-            mouse_report.v = times_inv_sqrt2(mouse_report.v);
-            if (mouse_report.v == 0) {
-                mouse_report.v = 1;
-            }
-            mouse_report.h = times_inv_sqrt2(mouse_report.h);
-            if (mouse_report.h == 0) {
-                mouse_report.h = 1;
-            }
+        if (tmpmr.v && tmpmr.h) {
+            velocity_v = velocity_v * 181 / 256;
+            velocity_h = velocity_h * 181 / 256;
         }
+        mouse_report.v = mousekey_move(&mousekey_v_axis, tmpmr.v, velocity_v, dt, MOUSEKEY_WHEEL_MAX * MOUSE_WHEEL_DETENT_V);
+        mouse_report.h = mousekey_move(&mousekey_h_axis, tmpmr.h, velocity_h, dt, MOUSEKEY_WHEEL_MAX * MOUSE_WHEEL_DETENT_H);
     }
 
     if (has_mouse_report_changed(&mouse_report, &tmpmr) || should_mousekey_report_send(&mouse_report)) {
@@ -429,13 +511,13 @@ void mousekey_on(uint8_t code) {
 #    endif // inertia or not
 
     else if (code == KC_MS_WH_UP)
-        mouse_report.v = wheel_unit();
+        mouse_report.v = wheel_unit() * MOUSE_WHEEL_DETENT_V;
     else if (code == KC_MS_WH_DOWN)
-        mouse_report.v = wheel_unit() * -1;
+        mouse_report.v = wheel_unit() * -MOUSE_WHEEL_DETENT_V;
     else if (code == KC_MS_WH_LEFT)
-        mouse_report.h = wheel_unit() * -1;
+        mouse_report.h = wheel_unit() * -MOUSE_WHEEL_DETENT_H;
     else if (code == KC_MS_WH_RIGHT)
-        mouse_report.h = wheel_unit();
+        mouse_report.h = wheel_unit() * MOUSE_WHEEL_DETENT_H;
     else if (IS_MOUSEKEY_BUTTON(code))
         mouse_report.buttons |= 1 << (code - KC_MS_BTN1);
     else if (code == KC_MS_ACCEL0)
@@ -493,8 +575,16 @@ void mousekey_off(uint8_t code) {
 #    ifdef MK_KINETIC_SPEED
         mouse_timer = 0;
 #    endif /* #ifdef MK_KINETIC_SPEED */
+#    ifndef MOUSEKEY_INERTIA
+        kinematics_stop(&mousekey_x_axis);
+        kinematics_stop(&mousekey_y_axis);
+#    endif
+    }
+    if (mouse_report.v == 0 && mouse_report.h == 0) {
+        mousekey_wheel_repeat = 0;
+        kinematics_stop(&mousekey_v_axis);
+        kinematics_stop(&mousekey_h_axis);
     }
-    if (mouse_report.v == 0 && mouse_report.h == 0) mousekey_wheel_repeat = 0;
 }
 
 #else /* #ifndef MK_3_SPEED */
@@ -538,15 +628,16 @@ void mousekey_task(void) {
 
 void adjust_speed(void) {
     uint16_t const c_offset = c_offsets[mk_speed];
-    uint16_t const w_offset = w_offsets[mk_speed];
+    uint16_t const w_offset_v = w_offsets[mk_speed] * MOUSE_WHEEL_DETENT_V;
+    uint16_t const w_offset_h = w_offsets[mk_speed] * MOUSE_WHEEL_DETENT_H;
     if (mouse_report.x > 0) mouse_report.x = c_offset;
     if (mouse_report.x < 0) mouse_report.x = c_offset * -1;
     if (mouse_report.y > 0) mouse_report.y = c_offset;
     if (mouse_report.y < 0) mouse_report.y = c_offset * -1;
-    if (mouse_report.h > 0) mouse_report.h = w_offset;
-    if (mouse_report.h < 0) mouse_report.h = w_offset * -1;
-    if (mouse_report.v > 0) mouse_report.v = w_offset;
-    if (mouse_report.v < 0) mouse_report.v = w_offset * -1;
+    if (mouse_report.h > 0) mouse_report.h = w_offset_h;
+    if (mouse_report.h < 0) mouse_report.h = w_offset_h * -1;
+    if (mouse_report.v > 0) mouse_report.v = w_offset_v;
+    if (mouse_report.v < 0) mouse_report.v = w_offset_v * -1;
     // adjust for diagonals
     if (mouse_report.x && mouse_report.y) {
         mouse_report.x = times_inv_sqrt2(mouse_report.x);
@@ -565,9 +656,10 @@ void adjust_speed(void) {
 }
 
 void mousekey_on(uint8_t code) {
-    uint16_t const c_offset  = c_offsets[mk_speed];
-    uint16_t const w_offset  = w_offsets[mk_speed];
-    uint8_t const  old_speed = mk_speed;
+    uint16_t const c_offset   = c_offsets[mk_speed];
+    uint16_t const w_offset_v = w_offsets[mk_speed] * MOUSE_WHEEL_DETENT_V;
+    uint16_t const w_offset_h = w_offsets[mk_speed] * MOUSE_WHEEL_DETENT_H;
+    uint8_t const  old_speed  = mk_speed;
     if (code == KC_MS_UP)
         mouse_report.y = c_offset * -1;
     else if (code == KC_MS_DOWN)
@@ -577,13 +669,13 @@ void mousekey_on(uint8_t code) {
     else if (code == KC_MS_RIGHT)
         mouse_report.x = c_offset;
     else if (code == KC_MS_WH_UP)
-        mouse_report.v = w_offset;
+        mouse_report.v = w_offset_v;
     else if (code == KC_MS_WH_DOWN)
-        mouse_report.v = w_offset * -1;
+        mouse_report.v = w_offset_v * -1;
     else if (code == KC_MS_WH_LEFT)
-        mouse_report.h = w_offset * -1;
+        mouse_report.h = w_offset_h * -1;
     else if (code == KC_MS_WH_RIGHT)
-        mouse_report.h = w_offset;
+        mouse_report.h = w_offset_h;
     else if (IS_MOUSEKEY_BUTTON(code))
         mouse_report.buttons |= 1 << (code - KC_MS_BTN1);
     else if (code == KC_MS_ACCEL0)
@@ -643,6 +735,12 @@ void mousekey_clear(void) {
     mousekey_repeat       = 0;
     mousekey_wheel_repeat = 0;
     mousekey_accel        = 0;
+#ifndef MK_3_SPEED
+    kinematics_stop(&mousekey_x_axis);
+    kinematics_stop(&mousekey_y_axis);
+    kinematics_stop(&mousekey_v_axis);
+    kinematics_stop(&mousekey_h_axis);
+#endif
 #ifdef MOUSEKEY_INERTIA
     mousekey_frame     = 0;
     mousekey_x_inertia = 0;
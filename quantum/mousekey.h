@@ -62,6 +62,9 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #            define MOUSEKEY_INTERVAL 20
 #        endif
 #    endif
+#    ifndef MOUSEKEY_REPORT_INTERVAL
+#        define MOUSEKEY_REPORT_INTERVAL MOUSEKEY_INTERVAL
+#    endif
 #    ifndef MOUSEKEY_MAX_SPEED
 #        if defined(MOUSEKEY_INERTIA)
 #            define MOUSEKEY_MAX_SPEED 32
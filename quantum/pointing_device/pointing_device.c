@@ -79,6 +79,22 @@ uint16_t pointing_device_get_shared_cpi(void) {
 static report_mouse_t local_mouse_report         = {};
 static bool           pointing_device_force_send = false;
 
+#ifdef POINTING_DEVICE_MOTION_INTERRUPT
+#    ifndef POINTING_DEVICE_MOTION_PIN
+#        error POINTING_DEVICE_MOTION_INTERRUPT requires POINTING_DEVICE_MOTION_PIN to be defined
+#    elif !defined(PROTOCOL_CHIBIOS)
+#        error POINTING_DEVICE_MOTION_INTERRUPT is only supported on ChibiOS
+#    elif !defined(PAL_USE_CALLBACKS) || PAL_USE_CALLBACKS != TRUE
+#        error POINTING_DEVICE_MOTION_INTERRUPT requires PAL_USE_CALLBACKS to be enabled in halconf.h
+#    endif
+
+static volatile bool pointing_device_motion_latched = false;
+
+static void pointing_device_motion_callback(void *arg) {
+    pointing_device_motion_latched = true;
+}
+#endif
+
 extern const pointing_device_driver_t pointing_device_driver;
 
 /**
@@ -153,6 +169,14 @@ __attribute__((weak)) void pointing_device_init(void) {
 #    else
         gpio_set_pin_input(POINTING_DEVICE_MOTION_PIN);
 #    endif
+#    ifdef POINTING_DEVICE_MOTION_INTERRUPT
+#        ifdef POINTING_DEVICE_MOTION_PIN_ACTIVE_LOW
+        palEnableLineEvent(POINTING_DEVICE_MOTION_PIN, PAL_EVENT_MODE_FALLING_EDGE);
+#        else
+        palEnableLineEvent(POINTING_DEVICE_MOTION_PIN, PAL_EVENT_MODE_RISING_EDGE);
+#        endif
+        palSetLineCallback(POINTING_DEVICE_MOTION_PIN, pointing_device_motion_callback, NULL);
+#    endif
 #endif
     }
 
@@ -160,6 +184,66 @@ __attribute__((weak)) void pointing_device_init(void) {
     pointing_device_init_user();
 }
 
+#ifdef POINTING_DEVICE_MOTION_PIN
+/**
+ * @brief Checks whether the pointing device on this side has signalled motion
+ *
+ * The motion pin is checked, as well as whether it has been activated since the last call when using
+ * POINTING_DEVICE_MOTION_INTERRUPT, so that motion signalled by a short pulse is not missed.
+ *
+ * @return true if the pointing device has motion to be read
+ */
+bool pointing_device_motion_detected(void) {
+    bool motion = false;
+#    ifdef POINTING_DEVICE_MOTION_INTERRUPT
+    motion                         = pointing_device_motion_latched;
+    pointing_device_motion_latched = false;
+#    endif
+#    ifdef POINTING_DEVICE_MOTION_PIN_ACTIVE_LOW
+    return motion || !gpio_read_pin(POINTING_DEVICE_MOTION_PIN);
+#    else
+    return motion || gpio_read_pin(POINTING_DEVICE_MOTION_PIN);
+#    endif
+}
+#endif
+
+/**
+ * @brief Gets the report of the pointing device on this side
+ *
+ * Only reads the pointing device if its motion pin, when defined, signals motion.
+ *
+ * @param[in] mouse_report report_mouse_t to be updated by the pointing device driver
+ * @return report_mouse_t
+ */
+static report_mouse_t pointing_device_get_local_report(report_mouse_t mouse_report) {
+#ifdef POINTING_DEVICE_MOTION_PIN
+    if (!pointing_device_motion_detected()) {
+        return mouse_report;
+    }
+#endif
+    return pointing_device_driver.get_report(mouse_report);
+}
+
+#ifdef MOUSE_HIRES_SCROLL_ENABLE
+static inline mouse_hv_report_t pointing_device_hv_clamp(hv_clamp_range_t value);
+
+/**
+ * @brief Scales the wheel movement of a report to the resolution the host asked for
+ *
+ * Pointing devices report the wheels in whole detents, which become fractions of a detent once the host enables the Resolution Multiplier.
+ *
+ * @param[in] mouse_report report_mouse_t in whole detents
+ * @return report_mouse_t in the resolution the host asked for
+ */
+static report_mouse_t pointing_device_scale_wheel(report_mouse_t mouse_report) {
+    mouse_report.h = pointing_device_hv_clamp((hv_clamp_range_t)mouse_report.h * MOUSE_WHEEL_DETENT_H);
+    mouse_report.v = pointing_device_hv_clamp((hv_clamp_range_t)mouse_report.v * MOUSE_WHEEL_DETENT_V);
+    return mouse_report;
+}
+#else
+#    define pointing_device_scale_wheel(mouse_report) (mouse_report)
+#endif
+
 /**
  * @brief Sends processed mouse report to host
  *
@@ -242,47 +326,35 @@ __attribute__((weak)) bool pointing_device_task(void) {
 #endif
 
     // Gather report info
-#ifdef POINTING_DEVICE_MOTION_PIN
-#    if defined(SPLIT_POINTING_ENABLE)
-#        error POINTING_DEVICE_MOTION_PIN not supported when sharing the pointing device report between sides.
-#    endif
-#    ifdef POINTING_DEVICE_MOTION_PIN_ACTIVE_LOW
-    if (!gpio_read_pin(POINTING_DEVICE_MOTION_PIN))
-#    else
-    if (gpio_read_pin(POINTING_DEVICE_MOTION_PIN))
-#    endif
-    {
-#endif
-
 #if defined(SPLIT_POINTING_ENABLE)
 #    if defined(POINTING_DEVICE_COMBINED)
-        static uint8_t old_buttons = 0;
-        local_mouse_report.buttons = old_buttons;
-        local_mouse_report         = pointing_device_driver.get_report(local_mouse_report);
-        old_buttons                = local_mouse_report.buttons;
+    static uint8_t old_buttons = 0;
+    local_mouse_report.buttons = old_buttons;
+    local_mouse_report         = pointing_device_get_local_report(local_mouse_report);
+    old_buttons                = local_mouse_report.buttons;
 #    elif defined(POINTING_DEVICE_LEFT) || defined(POINTING_DEVICE_RIGHT)
-        local_mouse_report = POINTING_DEVICE_THIS_SIDE ? pointing_device_driver.get_report(local_mouse_report) : shared_mouse_report;
+    local_mouse_report = POINTING_DEVICE_THIS_SIDE ? pointing_device_get_local_report(local_mouse_report) : shared_mouse_report;
 #    else
 #        error "You need to define the side(s) the pointing device is on. POINTING_DEVICE_COMBINED / POINTING_DEVICE_LEFT / POINTING_DEVICE_RIGHT"
 #    endif
 #else
-    local_mouse_report = pointing_device_driver.get_report(local_mouse_report);
+    local_mouse_report = pointing_device_get_local_report(local_mouse_report);
 #endif // defined(SPLIT_POINTING_ENABLE)
 
-#ifdef POINTING_DEVICE_MOTION_PIN
-    }
-#endif
+    local_mouse_report = pointing_device_scale_wheel(local_mouse_report);
 
     // allow kb to intercept and modify report
 #if defined(SPLIT_POINTING_ENABLE) && defined(POINTING_DEVICE_COMBINED)
+    // the shared report is kept until the other side sends a new one, so it is scaled as a copy
+    report_mouse_t shared_report = pointing_device_scale_wheel(shared_mouse_report);
     if (is_keyboard_left()) {
-        local_mouse_report  = pointing_device_adjust_by_defines(local_mouse_report);
-        shared_mouse_report = pointing_device_adjust_by_defines_right(shared_mouse_report);
+        local_mouse_report = pointing_device_adjust_by_defines(local_mouse_report);
+        shared_report      = pointing_device_adjust_by_defines_right(shared_report);
     } else {
-        local_mouse_report  = pointing_device_adjust_by_defines_right(local_mouse_report);
-        shared_mouse_report = pointing_device_adjust_by_defines(shared_mouse_report);
+        local_mouse_report = pointing_device_adjust_by_defines_right(local_mouse_report);
+        shared_report      = pointing_device_adjust_by_defines(shared_report);
     }
-    local_mouse_report = is_keyboard_left() ? pointing_device_task_combined_kb(local_mouse_report, shared_mouse_report) : pointing_device_task_combined_kb(shared_mouse_report, local_mouse_report);
+    local_mouse_report = is_keyboard_left() ? pointing_device_task_combined_kb(local_mouse_report, shared_report) : pointing_device_task_combined_kb(shared_report, local_mouse_report);
 #else
     local_mouse_report = pointing_device_adjust_by_defines(local_mouse_report);
     local_mouse_report = pointing_device_task_kb(local_mouse_report);
@@ -356,44 +428,24 @@ void pointing_device_set_cpi(uint16_t cpi) {
 #endif
 }
 
-#if defined(SPLIT_POINTING_ENABLE) && defined(POINTING_DEVICE_COMBINED)
 /**
- * @brief Set pointing device CPI if supported
- *
- * Takes a bool and uint16_t and allows setting cpi for a single side when using 2 pointing devices with a split keyboard.
- *
- * NOTE: Only available when using SPLIT_POINTING_ENABLE and POINTING_DEVICE_COMBINED
- *
- * @param[in] left true = left, false = right.
- * @param[in] cpi uint16_t value.
- */
-void pointing_device_set_cpi_on_side(bool left, uint16_t cpi) {
-    bool local = (is_keyboard_left() == left);
-    if (local) {
-        pointing_device_driver.set_cpi(cpi);
-    } else {
-        shared_cpi = cpi;
-    }
-}
-
-/**
- * @brief clamps int16_t to int8_t
+ * @brief clamps hv_clamp_range_t to mouse_hv_report_t
  *
- * @param[in] int16_t value
- * @return int8_t clamped value
+ * @param[in] hv_clamp_range_t value
+ * @return mouse_hv_report_t clamped value
  */
-static inline int8_t pointing_device_hv_clamp(int16_t value) {
-    if (value < INT8_MIN) {
-        return INT8_MIN;
-    } else if (value > INT8_MAX) {
-        return INT8_MAX;
+static inline mouse_hv_report_t pointing_device_hv_clamp(hv_clamp_range_t value) {
+    if (value < HV_REPORT_MIN) {
+        return HV_REPORT_MIN;
+    } else if (value > HV_REPORT_MAX) {
+        return HV_REPORT_MAX;
     } else {
         return value;
     }
 }
 
 /**
- * @brief clamps int16_t to int8_t
+ * @brief clamps clamp_range_t to mouse_xy_report_t
  *
  * @param[in] clamp_range_t value
  * @return mouse_xy_report_t clamped value
@@ -407,10 +459,59 @@ static inline mouse_xy_report_t pointing_device_xy_clamp(clamp_range_t value) {
         return value;
     }
 }
+
+/**
+ * @brief Takes as much of an accumulated movement as fits in a mouse report
+ *
+ * What does not fit is left in value, so that it can be sent with the next report rather than lost.
+ *
+ * @param[in,out] value clamp_range_t accumulated movement
+ * @return mouse_xy_report_t movement to report now
+ */
+mouse_xy_report_t pointing_device_xy_carry(clamp_range_t *value) {
+    mouse_xy_report_t movement = pointing_device_xy_clamp(*value);
+    *value -= movement;
+    return movement;
+}
+
+/**
+ * @brief Takes as much of an accumulated wheel movement as fits in a mouse report
+ *
+ * What does not fit is left in value, so that it can be sent with the next report rather than lost.
+ *
+ * @param[in,out] value hv_clamp_range_t accumulated wheel movement
+ * @return mouse_hv_report_t wheel movement to report now
+ */
+mouse_hv_report_t pointing_device_hv_carry(hv_clamp_range_t *value) {
+    mouse_hv_report_t movement = pointing_device_hv_clamp(*value);
+    *value -= movement;
+    return movement;
+}
+
+#if defined(SPLIT_POINTING_ENABLE) && defined(POINTING_DEVICE_COMBINED)
+/**
+ * @brief Set pointing device CPI if supported
+ *
+ * Takes a bool and uint16_t and allows setting cpi for a single side when using 2 pointing devices with a split keyboard.
+ *
+ * NOTE: Only available when using SPLIT_POINTING_ENABLE and POINTING_DEVICE_COMBINED
+ *
+ * @param[in] left true = left, false = right.
+ * @param[in] cpi uint16_t value.
+ */
+void pointing_device_set_cpi_on_side(bool left, uint16_t cpi) {
+    bool local = (is_keyboard_left() == left);
+    if (local) {
+        pointing_device_driver.set_cpi(cpi);
+    } else {
+        shared_cpi = cpi;
+    }
+}
+
 /**
  * @brief combines 2 mouse reports and returns 2
  *
- * Combines 2 report_mouse_t structs, clamping movement values to int8_t and ignores report_id then returns the resulting report_mouse_t struct.
+ * Combines 2 report_mouse_t structs, clamping movement values to the report range and ignores report_id then returns the resulting report_mouse_t struct.
  *
  * NOTE: Only available when using SPLIT_POINTING_ENABLE and POINTING_DEVICE_COMBINED
  *
@@ -421,8 +522,8 @@ static inline mouse_xy_report_t pointing_device_xy_clamp(clamp_range_t value) {
 report_mouse_t pointing_device_combine_reports(report_mouse_t left_report, report_mouse_t right_report) {
     left_report.x = pointing_device_xy_clamp((clamp_range_t)left_report.x + right_report.x);
     left_report.y = pointing_device_xy_clamp((clamp_range_t)left_report.y + right_report.y);
-    left_report.h = pointing_device_hv_clamp((int16_t)left_report.h + right_report.h);
-    left_report.v = pointing_device_hv_clamp((int16_t)left_report.v + right_report.v);
+    left_report.h = pointing_device_hv_clamp((hv_clamp_range_t)left_report.h + right_report.h);
+    left_report.v = pointing_device_hv_clamp((hv_clamp_range_t)left_report.v + right_report.v);
     left_report.buttons |= right_report.buttons;
     return left_report;
 }
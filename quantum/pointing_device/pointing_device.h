@@ -102,6 +102,16 @@ typedef int32_t clamp_range_t;
 typedef int16_t clamp_range_t;
 #endif
 
+#ifdef WHEEL_EXTENDED_REPORT
+#    define HV_REPORT_MIN INT16_MIN
+#    define HV_REPORT_MAX INT16_MAX
+typedef int32_t hv_clamp_range_t;
+#else
+#    define HV_REPORT_MIN INT8_MIN
+#    define HV_REPORT_MAX INT8_MAX
+typedef int16_t hv_clamp_range_t;
+#endif
+
 void           pointing_device_init(void);
 bool           pointing_device_task(void);
 bool           pointing_device_send(void);
@@ -118,6 +128,13 @@ uint8_t        pointing_device_handle_buttons(uint8_t buttons, bool pressed, poi
 report_mouse_t pointing_device_adjust_by_defines(report_mouse_t mouse_report);
 void           pointing_device_keycode_handler(uint16_t keycode, bool pressed);
 
+mouse_xy_report_t pointing_device_xy_carry(clamp_range_t *value);
+mouse_hv_report_t pointing_device_hv_carry(hv_clamp_range_t *value);
+
+#ifdef POINTING_DEVICE_MOTION_PIN
+bool pointing_device_motion_detected(void);
+#endif
+
 #if defined(SPLIT_POINTING_ENABLE)
 void     pointing_device_set_shared_report(report_mouse_t report);
 uint16_t pointing_device_get_shared_cpi(void);
@@ -50,8 +50,8 @@
 typedef struct {
     mouse_xy_report_t x;
     mouse_xy_report_t y;
-    int8_t            v;
-    int8_t            h;
+    mouse_hv_report_t v;
+    mouse_hv_report_t h;
 } total_mouse_movement_t;
 typedef struct {
     struct {
@@ -23,7 +23,7 @@
 #include "timer.h"
 #include <stddef.h>
 
-#define CONSTRAIN_HID(amt) ((amt) < INT8_MIN ? INT8_MIN : ((amt) > INT8_MAX ? INT8_MAX : (amt)))
+#define CONSTRAIN_HID_HV(amt) ((amt) < HV_REPORT_MIN ? HV_REPORT_MIN : ((amt) > HV_REPORT_MAX ? HV_REPORT_MAX : (amt)))
 #define CONSTRAIN_HID_XY(amt) ((amt) < XY_REPORT_MIN ? XY_REPORT_MIN : ((amt) > XY_REPORT_MAX ? XY_REPORT_MAX : (amt)))
 
 // get_report functions should probably be moved to their respective drivers.
@@ -77,8 +77,12 @@ const pointing_device_driver_t pointing_device_driver = {
 report_mouse_t adns9800_get_report_driver(report_mouse_t mouse_report) {
     report_adns9800_t sensor_report = adns9800_get_report();
 
-    mouse_report.x = CONSTRAIN_HID_XY(sensor_report.x);
-    mouse_report.y = CONSTRAIN_HID_XY(sensor_report.y);
+    static clamp_range_t x = 0, y = 0; // movement that did not fit in previous reports
+
+    x += sensor_report.x;
+    y += sensor_report.y;
+    mouse_report.x = pointing_device_xy_carry(&x);
+    mouse_report.y = pointing_device_xy_carry(&y);
 
     return mouse_report;
 }
@@ -192,8 +196,8 @@ report_mouse_t azoteq_iqs5xx_get_report(report_mouse_t mouse_report) {
                 }
             } else if (base_data.gesture_events_1.scroll) {
                 pd_dprintf("IQS5XX - Scroll.\n");
-                temp_report.h = CONSTRAIN_HID(AZOTEQ_IQS5XX_COMBINE_H_L_BYTES(base_data.x.h, base_data.x.l));
-                temp_report.v = CONSTRAIN_HID(AZOTEQ_IQS5XX_COMBINE_H_L_BYTES(base_data.y.h, base_data.y.l));
+                temp_report.h = CONSTRAIN_HID_HV(AZOTEQ_IQS5XX_COMBINE_H_L_BYTES(base_data.x.h, base_data.x.l));
+                temp_report.v = CONSTRAIN_HID_HV(AZOTEQ_IQS5XX_COMBINE_H_L_BYTES(base_data.y.h, base_data.y.l));
             }
             if (base_data.number_of_fingers == 1 && !ignore_movement) {
                 temp_report.x = CONSTRAIN_HID_XY(AZOTEQ_IQS5XX_COMBINE_H_L_BYTES(base_data.x.h, base_data.x.l));
@@ -308,9 +312,12 @@ report_mouse_t cirque_pinnacle_get_report(report_mouse_t mouse_report) {
 #        ifdef POINTING_DEVICE_GESTURES_CURSOR_GLIDE_ENABLE
         if (cursor_glide_enable) {
             if (touchData.touchDown) {
-                cursor_glide_update(&glide, report_x, report_y, touchData.zValue);
-            } else if (!glide_report.valid) {
-                glide_report = cursor_glide_start(&glide);
+                cursor_glide_update(&glide, report_x, report_y, touchData.zValue, touchData.timestamp);
+            } else {
+                if (!glide_report.valid) {
+                    glide_report = cursor_glide_start(&glide);
+                }
+                // glide steps come every report, samples included
                 if (glide_report.valid) {
                     report_x = glide_report.dx;
                     report_y = glide_report.dy;
@@ -391,20 +398,6 @@ const pointing_device_driver_t pointing_device_driver = {
 };
 #elif defined(POINTING_DEVICE_DRIVER_pimoroni_trackball)
 
-mouse_xy_report_t pimoroni_trackball_adapt_values(clamp_range_t* offset) {
-    if (*offset > XY_REPORT_MAX) {
-        *offset -= XY_REPORT_MAX;
-        return (mouse_xy_report_t)XY_REPORT_MAX;
-    } else if (*offset < XY_REPORT_MIN) {
-        *offset += XY_REPORT_MAX;
-        return (mouse_xy_report_t)XY_REPORT_MIN;
-    } else {
-        mouse_xy_report_t temp_return = *offset;
-        *offset                       = 0;
-        return temp_return;
-    }
-}
-
 report_mouse_t pimoroni_trackball_get_report(report_mouse_t mouse_report) {
     static uint16_t      debounce      = 0;
     static uint8_t       error_count   = 0;
@@ -422,8 +415,8 @@ report_mouse_t pimoroni_trackball_get_report(report_mouse_t mouse_report) {
                 if (!debounce) {
                     x_offset += pimoroni_trackball_get_offsets(pimoroni_data.right, pimoroni_data.left, PIMORONI_TRACKBALL_SCALE);
                     y_offset += pimoroni_trackball_get_offsets(pimoroni_data.down, pimoroni_data.up, PIMORONI_TRACKBALL_SCALE);
-                    mouse_report.x = pimoroni_trackball_adapt_values(&x_offset);
-                    mouse_report.y = pimoroni_trackball_adapt_values(&y_offset);
+                    mouse_report.x = pointing_device_xy_carry(&x_offset);
+                    mouse_report.y = pointing_device_xy_carry(&y_offset);
                 } else {
                     debounce--;
                 }
@@ -461,25 +454,30 @@ static uint16_t pmw33xx_get_cpi_wrapper(void) {
 }
 
 report_mouse_t pmw33xx_get_report(report_mouse_t mouse_report) {
-    pmw33xx_report_t report    = pmw33xx_read_burst(0);
-    static bool      in_motion = false;
+    pmw33xx_report_t     report    = pmw33xx_read_burst(0);
+    static bool          in_motion = false;
+    static clamp_range_t x = 0, y = 0; // movement that did not fit in previous reports
 
     if (report.motion.b.is_lifted) {
+        x = y = 0;
         return mouse_report;
     }
 
-    if (!report.motion.b.is_motion) {
+    if (report.motion.b.is_motion) {
+        if (!in_motion) {
+            in_motion = true;
+            pd_dprintf("PWM3360 (0): starting motion\n");
+        }
+        x += report.delta_x;
+        y += report.delta_y;
+    } else {
         in_motion = false;
-        return mouse_report;
     }
 
-    if (!in_motion) {
-        in_motion = true;
-        pd_dprintf("PWM3360 (0): starting motion\n");
+    if (x || y) {
+        mouse_report.x = pointing_device_xy_carry(&x);
+        mouse_report.y = pointing_device_xy_carry(&y);
     }
-
-    mouse_report.x = CONSTRAIN_HID_XY(report.delta_x);
-    mouse_report.y = CONSTRAIN_HID_XY(report.delta_y);
     return mouse_report;
 }
 
@@ -26,42 +26,26 @@ static void cursor_glide_stop(cursor_glide_context_t* glide) {
     memset(&glide->status, 0, sizeof(glide->status));
 }
 
-static cursor_glide_t cursor_glide(cursor_glide_context_t* glide) {
+/* Glides one step, as far as the cursor went since the last one */
+static cursor_glide_t cursor_glide(cursor_glide_context_t* glide, uint16_t dt) {
     cursor_glide_status_t* status = &glide->status;
     cursor_glide_t         report;
-    int32_t                p;
-    int32_t                x, y;
+    q16_t                  p;
 
-    if (status->v0 == 0) {
-        report.dx    = 0;
-        report.dy    = 0;
-        report.valid = false;
-        cursor_glide_stop(glide);
-        goto exit;
-    }
-
-    status->counter++;
-    /* Calculate current 1D position */
-    p = status->v0 * status->counter - (int32_t)glide->config.coef * status->counter * status->counter / 2;
+    /* Calculate 1D distance */
+    p = kinematics_brake_distance(&status->v, status->decel, dt > UINT8_MAX ? UINT8_MAX : dt);
     /*
-     * Translate to x & y axes
+     * Translate to x & y axes, keeping what is not reported yet of each
      * Done this way instead of applying friction to each axis separately, so we don't end up with the shorter axis stuck at 0 towards the end of diagonal movements.
      */
-    x            = (int32_t)(p * status->dx0 / status->v0);
-    y            = (int32_t)(p * status->dy0 / status->v0);
-    report.dx    = (mouse_xy_report_t)(x - status->x);
-    report.dy    = (mouse_xy_report_t)(y - status->y);
-    report.valid = true;
-    if (report.dx <= 1 && report.dx >= -1 && report.dy <= 1 && report.dy >= -1) {
-        /* Stop gliding once speed is low enough */
+    report.dx     = (mouse_xy_report_t)kinematics_take(&status->x, p / status->v0 * status->dx0);
+    report.dy     = (mouse_xy_report_t)kinematics_take(&status->y, p / status->v0 * status->dy0);
+    report.valid  = true;
+    status->timer = timer_read();
+    if (status->v == 0) {
+        /* Stop gliding once the cursor has stopped */
         cursor_glide_stop(glide);
-        goto exit;
     }
-    status->x     = x;
-    status->y     = y;
-    status->timer = timer_read();
-
-exit:
     return report;
 }
 
@@ -69,65 +53,51 @@ cursor_glide_t cursor_glide_check(cursor_glide_context_t* glide) {
     cursor_glide_t         invalid_report = {0, 0, false};
     cursor_glide_status_t* status         = &glide->status;
 
-    if (status->z || (status->dx0 == 0 && status->dy0 == 0) || timer_elapsed(status->timer) < glide->config.interval) {
+    /* Glides a step whenever time has passed, so as often as reports are made */
+    if (status->z || status->v == 0 || timer_elapsed(status->timer) < 1) {
         return invalid_report;
     } else {
-        return cursor_glide(glide);
-    }
-}
-
-static inline uint16_t sqrt32(uint32_t x) {
-    uint32_t l, m, h;
-
-    if (x == 0) {
-        return 0;
-    } else if (x > (UINT16_MAX >> 2)) {
-        /* Safe upper bound to avoid integer overflow with m * m */
-        h = UINT16_MAX;
-    } else {
-        /* Upper bound based on closest log2 */
-        h = (1 << (((__builtin_clzl(1) - __builtin_clzl(x) + 1) + 1) >> 1));
-    }
-    /* Lower bound based on closest log2 */
-    l = (1 << ((__builtin_clzl(1) - __builtin_clzl(x)) >> 1));
-
-    /* Binary search to find integer square root */
-    while (l != h - 1) {
-        m = (l + h) / 2;
-        if (m * m <= x) {
-            l = m;
-        } else {
-            h = m;
-        }
+        return cursor_glide(glide, timer_elapsed(status->timer));
     }
-    return l;
 }
 
 cursor_glide_t cursor_glide_start(cursor_glide_context_t* glide) {
     cursor_glide_t         invalid_report = {0, 0, false};
     cursor_glide_status_t* status         = &glide->status;
+    uint16_t               interval       = glide->config.interval ? glide->config.interval : 1;
+    uint16_t               sample         = status->sample_interval ? status->sample_interval : interval;
+    uint32_t               decel          = ((uint32_t)glide->config.coef << 8) / ((uint32_t)interval * interval); // Q8 pixels per interval per interval to Q16 per ms per ms
 
-    status->timer   = timer_read();
-    status->counter = 0;
-    status->v0      = (status->dx0 == 0 && status->dy0 == 0) ? 0.0 : sqrt32(((int32_t)status->dx0 * 256 * status->dx0 * 256) + ((int32_t)status->dy0 * 256 * status->dy0 * 256)); // skip trigonometry if not needed, calculate distance in Q8
-    status->x       = 0;
-    status->y       = 0;
-    status->z       = 0;
-
-    if (status->v0 < ((uint32_t)glide->config.trigger_px * 256)) { /* Q8 comparison */
+    if (status->v) {
+        /* Already gliding since the last lift */
+        return invalid_report;
+    }
+    status->v0    = kinematics_hypot(status->dx0, status->dy0); // skip trigonometry if not needed
+    status->v     = kinematics_rate(status->v0 > INT16_MAX ? INT16_MAX : status->v0, sample);
+    status->decel = decel < 1 ? 1 : decel > KINEMATICS_DECEL_MAX ? KINEMATICS_DECEL_MAX : decel;
+    status->x     = 0;
+    status->y     = 0;
+    status->z     = 0;
+
+    if (status->v0 == 0 || status->v0 < glide->config.trigger_px) {
         /* Not enough velocity to be worth gliding, abort */
         cursor_glide_stop(glide);
         return invalid_report;
     }
 
-    return cursor_glide(glide);
+    /* The first step covers the time the last movement was made over */
+    return cursor_glide(glide, sample);
 }
 
-void cursor_glide_update(cursor_glide_context_t* glide, mouse_xy_report_t dx, mouse_xy_report_t dy, uint16_t z) {
+void cursor_glide_update(cursor_glide_context_t* glide, mouse_xy_report_t dx, mouse_xy_report_t dy, uint16_t z, uint16_t timestamp) {
     cursor_glide_status_t* status = &glide->status;
 
-    status->dx0 = dx;
-    status->dy0 = dy;
-    status->z   = z;
+    /* Movements are measured between consecutive samples of the same touch */
+    status->sample_interval = status->z ? timestamp - status->sample_time : 0;
+    status->sample_time     = timestamp;
+    status->dx0             = dx;
+    status->dy0             = dy;
+    status->z               = z;
+    status->v               = 0; /* Touching stops the glide */
 }
 #endif
@@ -17,6 +17,7 @@
 
 #include <stdint.h>
 #include "report.h"
+#include "kinematics.h"
 
 #ifdef POINTING_DEVICE_GESTURES_CURSOR_GLIDE_ENABLE
 typedef struct {
@@ -28,16 +29,19 @@ typedef struct {
 typedef struct {
     uint16_t trigger_px; /* Pixels of movement needed to trigger cursor glide */
     uint16_t coef;       /* Coefficient of friction */
-    uint16_t interval;   /* Glide report interval, in milliseconds */
+    uint16_t interval;   /* Interval the friction is given over, and movements are sampled at if unknown, in milliseconds */
 } cursor_glide_config_t;
 
 typedef struct {
-    int32_t           v0;
-    int32_t           x;
-    int32_t           y;
+    q16_t             v;     /* Speed along the last movement, in pixels per ms */
+    q16_t             decel; /* Friction, in pixels per ms per ms */
+    q16_t             x;     /* Pixels moved but not reported yet */
+    q16_t             y;
+    uint16_t          v0;    /* Length of the last movement */
     uint16_t          z;
     uint16_t          timer;
-    uint16_t          counter;
+    uint16_t          sample_time;     /* When the last movement was sampled */
+    uint16_t          sample_interval; /* Time the last movement was made over, 0 if unknown */
     mouse_xy_report_t dx0;
     mouse_xy_report_t dy0;
 } cursor_glide_status_t;
@@ -53,6 +57,6 @@ cursor_glide_t cursor_glide_check(cursor_glide_context_t* glide);
 /* Start glide reporting, gives first set of glide coordinates */
 cursor_glide_t cursor_glide_start(cursor_glide_context_t* glide);
 
-/* Update glide engine on the latest cursor movement, cursor glide is based on the final movement */
-void cursor_glide_update(cursor_glide_context_t* glide, mouse_xy_report_t dx, mouse_xy_report_t dy, uint16_t z);
+/* Update glide engine on the latest cursor movement, sampled at the given timer value, cursor glide is based on the final movement */
+void cursor_glide_update(cursor_glide_context_t* glide, mouse_xy_report_t dx, mouse_xy_report_t dy, uint16_t z, uint16_t timestamp);
 #endif
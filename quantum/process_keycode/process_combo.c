@@ -16,6 +16,7 @@
 
 #include "process_combo.h"
 #include <stddef.h>
+#include <string.h>
 #include "process_auto_shift.h"
 #include "caps_word.h"
 #include "timer.h"
@@ -77,6 +78,86 @@ static uint16_t timer = 0;
 static bool     b_combo_enable = true; // defaults to enabled
 static uint16_t longest_term   = 0;
 
+#ifdef COMBO_INDEX
+/* Reverse index from keycodes to combos. Every combo is hashed by each of its
+ * keys into one of COMBO_INDEX_BUCKETS bitmaps, so that only the combos sharing
+ * a bucket with the key being processed have to be evaluated. An extra bitmap
+ * tracks the combos which may hold state, so that clearing them does not have
+ * to visit every combo either. The bitmaps are sized for the combos stored in
+ * firmware; if combo_count() exceeds that, all combos are scanned linearly. */
+#    define COMBO_INDEX_TOUCHED COMBO_INDEX_BUCKETS
+
+static bool     combo_index_valid = false;
+static uint16_t combo_index_count = 0;
+
+void combo_index_invalidate(void) {
+    combo_index_valid = false;
+}
+
+static inline uint8_t combo_index_bucket(uint16_t keycode) {
+    return (keycode ^ (keycode >> 8)) % COMBO_INDEX_BUCKETS;
+}
+
+static inline void combo_index_set(uint8_t bitmap, uint16_t combo_index) {
+    if (combo_index < combo_count_raw()) {
+        combo_index_bitmap_raw(bitmap)[combo_index / 8] |= 1 << (combo_index % 8);
+    }
+}
+
+/* Returns the first combo index from idx onwards which is set in the bitmap, or a value >= count if there is none. */
+static uint16_t combo_index_next(const uint8_t *bitmap, uint16_t idx, uint16_t count) {
+    while (idx < count) {
+        uint8_t bits = bitmap[idx / 8] >> (idx % 8);
+        if (!bits) {
+            idx = (idx | 7) + 1;
+            continue;
+        }
+        while (!(bits & 1)) {
+            bits >>= 1;
+            idx++;
+        }
+        break;
+    }
+    return idx;
+}
+
+static void combo_index_build(uint16_t count) {
+    uint16_t size = (combo_count_raw() + 7) / 8;
+    for (uint8_t bucket = 0; bucket < COMBO_INDEX_BUCKETS; ++bucket) {
+        memset(combo_index_bitmap_raw(bucket), 0, size);
+    }
+    // Make the next clear_combos() visit every combo
+    memset(combo_index_bitmap_raw(COMBO_INDEX_TOUCHED), 0xFF, size);
+
+    for (uint16_t idx = 0; idx < count; ++idx) {
+        const uint16_t *keys = combo_get(idx)->keys;
+        uint16_t        key;
+        for (uint8_t i = 0; (key = pgm_read_word(&keys[i])) != COMBO_END; ++i) {
+            combo_index_set(combo_index_bucket(key), idx);
+        }
+    }
+
+    combo_index_count = count;
+    combo_index_valid = true;
+}
+
+/* Returns the number of combos covered by the index, or 0 if they have to be scanned linearly. */
+static uint16_t combo_index_prepare(void) {
+    uint16_t count = combo_count();
+    if (count > combo_count_raw()) {
+        return 0;
+    }
+    if (!combo_index_valid || count != combo_index_count) {
+        combo_index_build(count);
+    }
+    return count;
+}
+
+#    define COMBO_INDEX_TOUCH(combo_index) combo_index_set(COMBO_INDEX_TOUCHED, combo_index)
+#else
+#    define COMBO_INDEX_TOUCH(combo_index)
+#endif
+
 typedef struct {
     keyrecord_t record;
     uint16_t    combo_index;
@@ -194,6 +275,20 @@ static inline uint16_t _get_combo_term(uint16_t combo_index, combo_t *combo) {
 void clear_combos(void) {
     uint16_t index = 0;
     longest_term   = 0;
+#ifdef COMBO_INDEX
+    uint16_t count = combo_index_prepare();
+    if (count) {
+        uint8_t *touched = combo_index_bitmap_raw(COMBO_INDEX_TOUCHED);
+        for (index = combo_index_next(touched, 0, count); index < count; index = combo_index_next(touched, index + 1, count)) {
+            combo_t *combo = combo_get(index);
+            if (!COMBO_ACTIVE(combo)) {
+                RESET_COMBO_STATE(combo);
+                touched[index / 8] &= ~(1 << (index % 8));
+            }
+        }
+        return;
+    }
+#endif
     for (index = 0; index < combo_count(); ++index) {
         combo_t *combo = combo_get(index);
         if (!COMBO_ACTIVE(combo)) {
@@ -288,6 +383,7 @@ void drop_combo_from_buffer(uint16_t combo_index) {
         if (qcombo->combo_index == combo_index) {
             combo_t *combo = combo_get(combo_index);
             DISABLE_COMBO(combo);
+            COMBO_INDEX_TOUCH(combo_index);
 
             if (i == combo_buffer_read) {
                 INCREMENT_MOD(combo_buffer_read);
@@ -423,6 +519,7 @@ static bool process_single_combo(combo_t *combo, uint16_t keycode, keyrecord_t *
     if (-1 == (int16_t)key_index) {
         return false;
     }
+    COMBO_INDEX_TOUCH(combo_index);
 
     bool key_is_part_of_combo = (!COMBO_DISABLED(combo) && is_combo_enabled()
 #if defined(COMBO_MUST_PRESS_IN_ORDER) || defined(COMBO_MUST_PRESS_IN_ORDER_PER_COMBO)
@@ -462,6 +559,7 @@ static bool process_single_combo(combo_t *combo, uint16_t keycode, keyrecord_t *
 
                     if ((drop = overlaps(buffered_combo, combo))) {
                         DISABLE_COMBO(drop);
+                        COMBO_INDEX_TOUCH(qcombo->combo_index);
                         if (drop == combo) {
                             // stop checking for overlaps if dropped combo was current combo.
                             break;
@@ -564,10 +662,24 @@ bool process_combo(uint16_t keycode, keyrecord_t *record) {
     }
 #endif
 
-    for (uint16_t idx = 0; idx < combo_count(); ++idx) {
-        combo_t *combo = combo_get(idx);
-        is_combo_key |= process_single_combo(combo, keycode, record, idx);
-        no_combo_keys_pressed = no_combo_keys_pressed && (NO_COMBO_KEYS_ARE_DOWN || COMBO_ACTIVE(combo) || COMBO_DISABLED(combo));
+#ifdef COMBO_INDEX
+    uint16_t count = combo_index_prepare();
+    if (count) {
+        /* Only evaluate the combos which may contain this keycode. */
+        const uint8_t *candidates = combo_index_bitmap_raw(combo_index_bucket(keycode));
+        for (uint16_t idx = combo_index_next(candidates, 0, count); idx < count; idx = combo_index_next(candidates, idx + 1, count)) {
+            combo_t *combo = combo_get(idx);
+            is_combo_key |= process_single_combo(combo, keycode, record, idx);
+            no_combo_keys_pressed = no_combo_keys_pressed && (NO_COMBO_KEYS_ARE_DOWN || COMBO_ACTIVE(combo) || COMBO_DISABLED(combo));
+        }
+    } else
+#endif
+    {
+        for (uint16_t idx = 0; idx < combo_count(); ++idx) {
+            combo_t *combo = combo_get(idx);
+            is_combo_key |= process_single_combo(combo, keycode, record, idx);
+            no_combo_keys_pressed = no_combo_keys_pressed && (NO_COMBO_KEYS_ARE_DOWN || COMBO_ACTIVE(combo) || COMBO_DISABLED(combo));
+        }
     }
 
     if (record->event.pressed && is_combo_key) {
@@ -39,6 +39,14 @@
 #    define COMBO_BUFFER_LENGTH 4
 #endif
 
+#ifdef COMBO_INDEX
+#    ifndef COMBO_INDEX_BUCKETS
+#        define COMBO_INDEX_BUCKETS 32
+#    endif
+// One bitmap per keycode hash bucket, plus one for the combos that may hold state
+#    define COMBO_INDEX_BITMAP_COUNT (COMBO_INDEX_BUCKETS + 1)
+#endif
+
 typedef struct combo_t {
     const uint16_t *keys;
     uint16_t        keycode;
@@ -81,3 +89,7 @@ void combo_enable(void);
 void combo_disable(void);
 void combo_toggle(void);
 bool is_combo_enabled(void);
+
+#ifdef COMBO_INDEX
+void combo_index_invalidate(void);
+#endif
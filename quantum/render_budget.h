@@ -0,0 +1,67 @@
+// Copyright 2024 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include <stdint.h>
+#include "cycle_counter.h"
+
+#ifdef PROTOCOL_ARM_ATSAM
+#    error "Render budgets need a cycle counter, which arm_atsam does not provide"
+#endif
+
+/* Sizes the slices of LEDs that rgb_matrix and led_matrix render per task run
+ * so that each takes about a fixed time, from a running average of how long
+ * the current effect takes per LED.
+ *
+ * Both are kept in Q8 fixed point, 1/256 of a cycle counter unit, so that the
+ * cost of an LED still adapts when it is well below one unit, as it is on
+ * coarse counters such as the system tick fallback on Cortex-M0.
+ */
+#define RENDER_BUDGET_Q 8
+
+typedef struct {
+    uint32_t budget;   // time allowed per slice, in Q8 cycle counter units
+    uint32_t led_cost; // average time per LED, in Q8 cycle counter units, 0 until measured
+    uint32_t start;
+} render_budget_t;
+
+// Shifts a time in cycle counter units to Q8, saturating
+static inline uint32_t render_budget_to_q8(uint32_t cycles) {
+    return cycles > (UINT32_MAX >> RENDER_BUDGET_Q) ? UINT32_MAX : cycles << RENDER_BUDGET_Q;
+}
+
+static inline void render_budget_init(render_budget_t *render_budget, uint32_t budget_us) {
+    render_budget->budget   = render_budget_to_q8(cycle_counter_from_us(budget_us));
+    render_budget->led_cost = 0;
+}
+
+// Forgets the time measured so far, for when the effect changes
+static inline void render_budget_reset(render_budget_t *render_budget) {
+    render_budget->led_cost = 0;
+}
+
+// Returns how many LEDs fit in the budget, or fallback until the cost is known
+static inline uint8_t render_budget_slice(const render_budget_t *render_budget, uint8_t fallback) {
+    if (!render_budget->led_cost) {
+        return fallback;
+    }
+    uint32_t leds = render_budget->budget / render_budget->led_cost;
+    return leds < 1 ? 1 : leds > UINT8_MAX ? UINT8_MAX : leds;
+}
+
+static inline void render_budget_begin(render_budget_t *render_budget) {
+    render_budget->start = cycle_counter_read();
+}
+
+static inline void render_budget_end(render_budget_t *render_budget, uint8_t leds) {
+    if (!leds) {
+        return;
+    }
+    // A slice shorter than one counter unit still costs something, 1/256 of a unit is the least that can be kept
+    uint32_t cost = render_budget_to_q8(cycle_counter_read() - render_budget->start) / leds;
+    if (!cost) {
+        cost = 1;
+    }
+    render_budget->led_cost = render_budget->led_cost ? (uint32_t)(((uint64_t)render_budget->led_cost * 3 + cost) / 4) : cost;
+}
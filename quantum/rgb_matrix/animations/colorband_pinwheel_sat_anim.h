@@ -2,13 +2,13 @@
 RGB_MATRIX_EFFECT(BAND_PINWHEEL_SAT)
 #    ifdef RGB_MATRIX_CUSTOM_EFFECT_IMPLS
 
-static HSV BAND_PINWHEEL_SAT_math(HSV hsv, int16_t dx, int16_t dy, uint8_t time) {
-    hsv.s = scale8(hsv.s - time - atan2_8(dy, dx) * 3, hsv.s);
+static HSV BAND_PINWHEEL_SAT_math(HSV hsv, uint8_t i, uint8_t time) {
+    hsv.s = scale8(hsv.s - time - rgb_matrix_led_angle(i) * 3, hsv.s);
     return hsv;
 }
 
 bool BAND_PINWHEEL_SAT(effect_params_t* params) {
-    return effect_runner_dx_dy(params, &BAND_PINWHEEL_SAT_math);
+    return effect_runner_polar(params, &BAND_PINWHEEL_SAT_math);
 }
 
 #    endif // RGB_MATRIX_CUSTOM_EFFECT_IMPLS
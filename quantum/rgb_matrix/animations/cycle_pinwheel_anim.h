@@ -2,13 +2,13 @@
 RGB_MATRIX_EFFECT(CYCLE_PINWHEEL)
 #    ifdef RGB_MATRIX_CUSTOM_EFFECT_IMPLS
 
-static HSV CYCLE_PINWHEEL_math(HSV hsv, int16_t dx, int16_t dy, uint8_t time) {
-    hsv.h = atan2_8(dy, dx) + time;
+static HSV CYCLE_PINWHEEL_math(HSV hsv, uint8_t i, uint8_t time) {
+    hsv.h = rgb_matrix_led_angle(i) + time;
     return hsv;
 }
 
 bool CYCLE_PINWHEEL(effect_params_t* params) {
-    return effect_runner_dx_dy(params, &CYCLE_PINWHEEL_math);
+    return effect_runner_polar(params, &CYCLE_PINWHEEL_math);
 }
 
 #    endif // RGB_MATRIX_CUSTOM_EFFECT_IMPLS
@@ -0,0 +1,18 @@
+#pragma once
+
+// Effects look up the LED's distance and angle from the center with
+// rgb_matrix_led_dist() and rgb_matrix_led_angle()
+typedef HSV (*polar_f)(HSV hsv, uint8_t i, uint8_t time);
+
+bool effect_runner_polar(effect_params_t* params, polar_f effect_func) {
+    RGB_MATRIX_USE_LIMITS(led_min, led_max);
+
+    rgb_matrix_hsv_batch_t batch = {0};
+    uint8_t                time  = scale16by8(g_rgb_timer, rgb_matrix_config.speed / 2);
+    for (uint8_t i = led_min; i < led_max; i++) {
+        RGB_MATRIX_TEST_LED_FLAGS();
+        rgb_matrix_hsv_batch_set(&batch, i, effect_func(rgb_matrix_config.hsv, i, time));
+    }
+    rgb_matrix_hsv_batch_flush(&batch);
+    return rgb_matrix_check_finished_leds(led_max);
+}
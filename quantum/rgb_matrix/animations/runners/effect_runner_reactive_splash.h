@@ -4,14 +4,37 @@
 
 typedef HSV (*reactive_splash_f)(HSV hsv, int16_t dx, int16_t dy, uint8_t dist, uint16_t tick);
 
-bool effect_runner_reactive_splash(uint8_t start, effect_params_t* params, reactive_splash_f effect_func) {
+/* Returns how far from a hit its effect_func can change the value of an LED,
+ * given the hit's tick. Past that distance, effect_func must leave hsv.v as is.
+ */
+typedef uint8_t (*reactive_splash_reach_f)(uint16_t tick);
+
+bool effect_runner_reactive_splash_reach(uint8_t start, effect_params_t* params, reactive_splash_f effect_func, reactive_splash_reach_f reach_func) {
     RGB_MATRIX_USE_LIMITS(led_min, led_max);
 
-    uint8_t count = g_last_hit_tracker.count;
+    rgb_matrix_hsv_batch_t batch = {0};
+    uint8_t                count = g_last_hit_tracker.count;
+    rgb_matrix_tiles_t     tiles = UINT32_MAX;
+
+    // LEDs in tiles out of reach of every hit stay off, without going through the hits
+    if (reach_func) {
+        tiles = 0;
+        for (uint8_t j = start; j < count; j++) {
+            uint16_t tick = scale16by8(g_last_hit_tracker.tick[j], qadd8(rgb_matrix_config.speed, 1));
+            tiles |= rgb_matrix_tiles_around(g_last_hit_tracker.x[j], g_last_hit_tracker.y[j], reach_func(tick));
+        }
+    }
+    HSV hsv_off = rgb_matrix_config.hsv;
+    hsv_off.v   = 0;
+    RGB rgb_off = rgb_matrix_hsv_to_rgb(hsv_off);
+
     for (uint8_t i = led_min; i < led_max; i++) {
         RGB_MATRIX_TEST_LED_FLAGS();
-        HSV hsv = rgb_matrix_config.hsv;
-        hsv.v   = 0;
+        if (!(tiles & rgb_matrix_led_tile(i))) {
+            rgb_matrix_set_color(i, rgb_off.r, rgb_off.g, rgb_off.b);
+            continue;
+        }
+        HSV hsv = hsv_off;
         for (uint8_t j = start; j < count; j++) {
             int16_t  dx   = g_led_config.point[i].x - g_last_hit_tracker.x[j];
             int16_t  dy   = g_led_config.point[i].y - g_last_hit_tracker.y[j];
@@ -19,11 +42,15 @@ bool effect_runner_reactive_splash(uint8_t start, effect_params_t* params, react
             uint16_t tick = scale16by8(g_last_hit_tracker.tick[j], qadd8(rgb_matrix_config.speed, 1));
             hsv           = effect_func(hsv, dx, dy, dist, tick);
         }
-        hsv.v   = scale8(hsv.v, rgb_matrix_config.hsv.v);
-        RGB rgb = rgb_matrix_hsv_to_rgb(hsv);
-        rgb_matrix_set_color(i, rgb.r, rgb.g, rgb.b);
+        hsv.v = scale8(hsv.v, rgb_matrix_config.hsv.v);
+        rgb_matrix_hsv_batch_set(&batch, i, hsv);
     }
+    rgb_matrix_hsv_batch_flush(&batch);
     return rgb_matrix_check_finished_leds(led_max);
 }
 
+bool effect_runner_reactive_splash(uint8_t start, effect_params_t* params, reactive_splash_f effect_func) {
+    return effect_runner_reactive_splash_reach(start, params, effect_func, NULL);
+}
+
 #endif // RGB_MATRIX_KEYREACTIVE_ENABLED
@@ -28,6 +28,22 @@
 #include <stdlib.h>
 
 #include <lib/lib8tion/lib8tion.h>
+#ifdef RGB_MATRIX_RENDER_BUDGET_US
+#    include "render_budget.h"
+#endif
+
+#ifdef RGB_MATRIX_FLUSH_THREAD
+#    ifndef PROTOCOL_CHIBIOS
+#        error RGB_MATRIX_FLUSH_THREAD is only supported on ChibiOS
+#    endif
+#    include <ch.h>
+#    ifndef RGB_MATRIX_FLUSH_THREAD_STACK_SIZE
+#        define RGB_MATRIX_FLUSH_THREAD_STACK_SIZE 512
+#    endif
+#    ifndef RGB_MATRIX_FLUSH_THREAD_PRIORITY
+#        define RGB_MATRIX_FLUSH_THREAD_PRIORITY (NORMALPRIO + 1)
+#    endif
+#endif
 
 #ifndef RGB_MATRIX_CENTER
 const led_point_t k_rgb_matrix_center = {112, 32};
@@ -39,6 +55,88 @@ __attribute__((weak)) RGB rgb_matrix_hsv_to_rgb(HSV hsv) {
     return hsv_to_rgb(hsv);
 }
 
+#ifdef RGB_MATRIX_HSV_TO_RGB_BATCH
+#    ifndef RGB_MATRIX_HSV_TO_RGB_BATCH_SIZE
+#        define RGB_MATRIX_HSV_TO_RGB_BATCH_SIZE 16
+#    endif
+
+__attribute__((weak)) void rgb_matrix_hsv_to_rgb_batch(const HSV *hsv, RGB *rgb, uint8_t count) {
+    hsv_to_rgb_batch(hsv, rgb, count);
+}
+#endif
+
+// Colors produced by the effect runners, converted to RGB a batch at a time
+// with RGB_MATRIX_HSV_TO_RGB_BATCH, or one at a time otherwise
+typedef struct {
+    uint8_t count;
+#ifdef RGB_MATRIX_HSV_TO_RGB_BATCH
+    uint8_t index[RGB_MATRIX_HSV_TO_RGB_BATCH_SIZE];
+    HSV     hsv[RGB_MATRIX_HSV_TO_RGB_BATCH_SIZE];
+#endif
+} rgb_matrix_hsv_batch_t;
+
+static void rgb_matrix_hsv_batch_flush(rgb_matrix_hsv_batch_t *batch) {
+#ifdef RGB_MATRIX_HSV_TO_RGB_BATCH
+    RGB rgb[RGB_MATRIX_HSV_TO_RGB_BATCH_SIZE];
+
+    rgb_matrix_hsv_to_rgb_batch(batch->hsv, rgb, batch->count);
+    for (uint8_t i = 0; i < batch->count; i++) {
+        rgb_matrix_set_color(batch->index[i], rgb[i].r, rgb[i].g, rgb[i].b);
+    }
+    batch->count = 0;
+#endif
+}
+
+static inline void rgb_matrix_hsv_batch_set(rgb_matrix_hsv_batch_t *batch, uint8_t index, HSV hsv) {
+#ifdef RGB_MATRIX_HSV_TO_RGB_BATCH
+    batch->index[batch->count] = index;
+    batch->hsv[batch->count]   = hsv;
+    if (++batch->count == RGB_MATRIX_HSV_TO_RGB_BATCH_SIZE) {
+        rgb_matrix_hsv_batch_flush(batch);
+    }
+#else
+    RGB rgb = rgb_matrix_hsv_to_rgb(hsv);
+    rgb_matrix_set_color(index, rgb.r, rgb.g, rgb.b);
+#endif
+}
+
+#ifdef RGB_MATRIX_LED_POLAR_CACHE
+// Distance and angle of each LED from the center, worked out once rather than
+// for every LED in every frame of the spiral and pinwheel effects
+static struct {
+    uint8_t dist;
+    uint8_t angle;
+} led_polar[RGB_MATRIX_LED_COUNT];
+
+void rgb_matrix_update_led_polar(void) {
+    for (uint8_t i = 0; i < RGB_MATRIX_LED_COUNT; i++) {
+        int16_t dx = g_led_config.point[i].x - k_rgb_matrix_center.x;
+        int16_t dy = g_led_config.point[i].y - k_rgb_matrix_center.y;
+
+        led_polar[i].dist  = sqrt16(dx * dx + dy * dy);
+        led_polar[i].angle = atan2_8(dy, dx);
+    }
+}
+#endif
+
+static inline uint8_t rgb_matrix_led_dist(uint8_t led_idx) {
+#ifdef RGB_MATRIX_LED_POLAR_CACHE
+    return led_polar[led_idx].dist;
+#else
+    int16_t dx = g_led_config.point[led_idx].x - k_rgb_matrix_center.x;
+    int16_t dy = g_led_config.point[led_idx].y - k_rgb_matrix_center.y;
+    return sqrt16(dx * dx + dy * dy);
+#endif
+}
+
+static inline uint8_t rgb_matrix_led_angle(uint8_t led_idx) {
+#ifdef RGB_MATRIX_LED_POLAR_CACHE
+    return led_polar[led_idx].angle;
+#else
+    return atan2_8(g_led_config.point[led_idx].y - k_rgb_matrix_center.y, g_led_config.point[led_idx].x - k_rgb_matrix_center.x);
+#endif
+}
+
 // Generic effect runners
 #include "rgb_matrix_runners.inc"
 
@@ -76,6 +174,10 @@ static uint8_t         rgb_last_enable   = UINT8_MAX;
 static uint8_t         rgb_last_effect   = UINT8_MAX;
 static effect_params_t rgb_effect_params = {0, LED_FLAG_ALL, false};
 static rgb_task_states rgb_task_state    = SYNCING;
+#ifdef RGB_MATRIX_RENDER_BUDGET_US
+static render_budget_t            rgb_render_budget;
+static struct rgb_matrix_limits_t rgb_render_slice;
+#endif // RGB_MATRIX_RENDER_BUDGET_US
 
 // double buffers
 static uint32_t rgb_timer_buffer;
@@ -88,6 +190,46 @@ static last_hit_t last_hit_buffer;
 const uint8_t k_rgb_matrix_split[2] = RGB_MATRIX_SPLIT;
 #endif
 
+#ifdef RGB_MATRIX_FLUSH_THREAD
+// Effects render into the back buffer, completed frames are copied to the
+// front buffer which the flush thread hands over to the driver
+static RGB                rgb_back_buffer[RGB_MATRIX_LED_COUNT];
+static RGB                rgb_front_buffer[RGB_MATRIX_LED_COUNT];
+static binary_semaphore_t rgb_flush_request;
+static binary_semaphore_t rgb_flush_idle;
+
+static THD_WORKING_AREA(rgb_matrix_flush_thread_wa, RGB_MATRIX_FLUSH_THREAD_STACK_SIZE);
+
+static THD_FUNCTION(rgb_matrix_flush_thread, arg) {
+    (void)arg;
+    chRegSetThreadName("rgb_matrix_flush");
+
+    while (true) {
+        chBSemWait(&rgb_flush_request);
+        for (uint8_t i = 0; i < RGB_MATRIX_LED_COUNT; i++) {
+            rgb_matrix_driver.set_color(i, rgb_front_buffer[i].r, rgb_front_buffer[i].g, rgb_front_buffer[i].b);
+        }
+        // Sleeps while waiting on the bus, letting the main loop run
+        rgb_matrix_driver.flush();
+        chBSemSignal(&rgb_flush_idle);
+    }
+}
+
+static bool rgb_matrix_flush_frame(bool wait) {
+    if (chBSemWaitTimeout(&rgb_flush_idle, wait ? TIME_INFINITE : TIME_IMMEDIATE) != MSG_OK) {
+        // The previous frame is still being flushed
+        return false;
+    }
+    memcpy(rgb_front_buffer, rgb_back_buffer, sizeof(rgb_front_buffer));
+    chBSemSignal(&rgb_flush_request);
+    if (wait) {
+        chBSemWait(&rgb_flush_idle);
+        chBSemSignal(&rgb_flush_idle);
+    }
+    return true;
+}
+#endif // RGB_MATRIX_FLUSH_THREAD
+
 EECONFIG_DEBOUNCE_HELPER(rgb_matrix, EECONFIG_RGB_MATRIX, rgb_matrix_config);
 
 void eeconfig_update_rgb_matrix(void) {
@@ -140,15 +282,27 @@ uint8_t rgb_matrix_map_row_column_to_led(uint8_t row, uint8_t column, uint8_t *l
 }
 
 void rgb_matrix_update_pwm_buffers(void) {
+#ifdef RGB_MATRIX_FLUSH_THREAD
+    rgb_matrix_flush_frame(true);
+#else
     rgb_matrix_driver.flush();
+#endif // RGB_MATRIX_FLUSH_THREAD
 }
 
 void rgb_matrix_set_color(int index, uint8_t red, uint8_t green, uint8_t blue) {
+#ifdef RGB_MATRIX_FLUSH_THREAD
+    if (index >= 0 && index < RGB_MATRIX_LED_COUNT) {
+        rgb_back_buffer[index].r = red;
+        rgb_back_buffer[index].g = green;
+        rgb_back_buffer[index].b = blue;
+    }
+#else
     rgb_matrix_driver.set_color(index, red, green, blue);
+#endif // RGB_MATRIX_FLUSH_THREAD
 }
 
 void rgb_matrix_set_color_all(uint8_t red, uint8_t green, uint8_t blue) {
-#if defined(RGB_MATRIX_SPLIT)
+#if defined(RGB_MATRIX_SPLIT) || defined(RGB_MATRIX_FLUSH_THREAD)
     for (uint8_t i = 0; i < RGB_MATRIX_LED_COUNT; i++)
         rgb_matrix_set_color(i, red, green, blue);
 #else
@@ -267,6 +421,9 @@ static void rgb_task_sync(void) {
 static void rgb_task_start(void) {
     // reset iter
     rgb_effect_params.iter = 0;
+#ifdef RGB_MATRIX_RENDER_BUDGET_US
+    rgb_render_slice.led_max_index = 0;
+#endif // RGB_MATRIX_RENDER_BUDGET_US
 
     // update double buffers
     g_rgb_timer = rgb_timer_buffer;
@@ -286,6 +443,16 @@ static void rgb_task_render(uint8_t effect) {
         rgb_matrix_set_color_all(0, 0, 0);
     }
 
+#ifdef RGB_MATRIX_RENDER_BUDGET_US
+    // size the next slice from what the effect has cost so far
+    if (rgb_effect_params.init && rgb_effect_params.iter == 0) {
+        render_budget_reset(&rgb_render_budget);
+    }
+    rgb_render_slice.led_min_index = rgb_render_slice.led_max_index;
+    rgb_render_slice.led_max_index = MIN(rgb_render_slice.led_min_index + render_budget_slice(&rgb_render_budget, RGB_MATRIX_LED_PROCESS_LIMIT), RGB_MATRIX_LED_COUNT);
+    render_budget_begin(&rgb_render_budget);
+#endif // RGB_MATRIX_RENDER_BUDGET_US
+
     // each effect can opt to do calculations
     // and/or request PWM buffer updates.
     switch (effect) {
@@ -326,6 +493,11 @@ static void rgb_task_render(uint8_t effect) {
             return;
     }
 
+#ifdef RGB_MATRIX_RENDER_BUDGET_US
+    struct rgb_matrix_limits_t limits = rgb_matrix_get_limits(rgb_effect_params.iter);
+    render_budget_end(&rgb_render_budget, limits.led_max_index > limits.led_min_index ? limits.led_max_index - limits.led_min_index : 0);
+#endif // RGB_MATRIX_RENDER_BUDGET_US
+
     rgb_effect_params.iter++;
 
     // next task
@@ -339,12 +511,21 @@ static void rgb_task_render(uint8_t effect) {
 }
 
 static void rgb_task_flush(uint8_t effect) {
+#ifdef RGB_MATRIX_FLUSH_THREAD
+    // hand the frame over to the flush thread, or retry on the next task run
+    if (!rgb_matrix_flush_frame(false)) {
+        return;
+    }
+#endif // RGB_MATRIX_FLUSH_THREAD
+
     // update last trackers after the first full render so we can init over several frames
     rgb_last_effect = effect;
     rgb_last_enable = rgb_matrix_config.enable;
 
+#ifndef RGB_MATRIX_FLUSH_THREAD
     // update pwm buffers
     rgb_matrix_update_pwm_buffers();
+#endif // RGB_MATRIX_FLUSH_THREAD
 
     // next task
     rgb_task_state = SYNCING;
@@ -399,7 +580,14 @@ __attribute__((weak)) bool rgb_matrix_indicators_user(void) {
 
 struct rgb_matrix_limits_t rgb_matrix_get_limits(uint8_t iter) {
     struct rgb_matrix_limits_t limits = {0};
-#if defined(RGB_MATRIX_LED_PROCESS_LIMIT) && RGB_MATRIX_LED_PROCESS_LIMIT > 0 && RGB_MATRIX_LED_PROCESS_LIMIT < RGB_MATRIX_LED_COUNT
+#if defined(RGB_MATRIX_RENDER_BUDGET_US)
+    limits = rgb_render_slice;
+#    if defined(RGB_MATRIX_SPLIT)
+    uint8_t k_rgb_matrix_split[2] = RGB_MATRIX_SPLIT;
+    if (is_keyboard_left() && (limits.led_max_index > k_rgb_matrix_split[0])) limits.led_max_index = k_rgb_matrix_split[0];
+    if (!(is_keyboard_left()) && (limits.led_min_index < k_rgb_matrix_split[0])) limits.led_min_index = k_rgb_matrix_split[0];
+#    endif
+#elif defined(RGB_MATRIX_LED_PROCESS_LIMIT) && RGB_MATRIX_LED_PROCESS_LIMIT > 0 && RGB_MATRIX_LED_PROCESS_LIMIT < RGB_MATRIX_LED_COUNT
 #    if defined(RGB_MATRIX_SPLIT)
     limits.led_min_index = RGB_MATRIX_LED_PROCESS_LIMIT * (iter);
     limits.led_max_index = limits.led_min_index + RGB_MATRIX_LED_PROCESS_LIMIT;
@@ -427,6 +615,20 @@ struct rgb_matrix_limits_t rgb_matrix_get_limits(uint8_t iter) {
     return limits;
 }
 
+rgb_matrix_tiles_t rgb_matrix_tiles_around(uint8_t x, uint8_t y, uint8_t reach) {
+    uint8_t col_min = qsub8(x, reach) >> 5;
+    uint8_t col_max = qadd8(x, reach) >> 5;
+    uint8_t row_min = MIN(qsub8(y, reach) >> 4, 3);
+    uint8_t row_max = MIN(qadd8(y, reach) >> 4, 3);
+    uint8_t cols    = (0xFF >> (7 - col_max)) & (0xFF << col_min);
+
+    rgb_matrix_tiles_t tiles = 0;
+    for (uint8_t row = row_min; row <= row_max; row++) {
+        tiles |= (rgb_matrix_tiles_t)cols << (row * 8);
+    }
+    return tiles;
+}
+
 void rgb_matrix_indicators_advanced(effect_params_t *params) {
     /* special handling is needed for "params->iter", since it's already been incremented.
      * Could move the invocations to rgb_task_render, but then it's missing a few checks
@@ -448,6 +650,20 @@ __attribute__((weak)) bool rgb_matrix_indicators_advanced_user(uint8_t led_min,
 void rgb_matrix_init(void) {
     rgb_matrix_driver.init();
 
+#ifdef RGB_MATRIX_RENDER_BUDGET_US
+    render_budget_init(&rgb_render_budget, RGB_MATRIX_RENDER_BUDGET_US);
+#endif // RGB_MATRIX_RENDER_BUDGET_US
+
+#ifdef RGB_MATRIX_LED_POLAR_CACHE
+    rgb_matrix_update_led_polar();
+#endif
+
+#ifdef RGB_MATRIX_FLUSH_THREAD
+    chBSemObjectInit(&rgb_flush_request, true);
+    chBSemObjectInit(&rgb_flush_idle, false);
+    chThdCreateStatic(rgb_matrix_flush_thread_wa, sizeof(rgb_matrix_flush_thread_wa), RGB_MATRIX_FLUSH_THREAD_PRIORITY, rgb_matrix_flush_thread, NULL);
+#endif // RGB_MATRIX_FLUSH_THREAD
+
 #ifdef RGB_MATRIX_KEYREACTIVE_ENABLED
     g_last_hit_tracker.count = 0;
     for (uint8_t i = 0; i < LED_HITS_TO_REMEMBER; ++i) {
@@ -472,7 +688,12 @@ void rgb_matrix_set_suspend_state(bool state) {
 #ifdef RGB_MATRIX_SLEEP
     if (state && !suspend_state) { // only run if turning off, and only once
         rgb_task_render(0);        // turn off all LEDs when suspending
-        rgb_task_flush(0);         // and actually flash led state to LEDs
+#    ifdef RGB_MATRIX_FLUSH_THREAD
+        // let any frame in flight complete, so that this one isn't deferred
+        chBSemWait(&rgb_flush_idle);
+        chBSemSignal(&rgb_flush_idle);
+#    endif
+        rgb_task_flush(0); // and actually flash led state to LEDs
     }
     suspend_state = state;
 #endif
@@ -148,6 +148,17 @@ uint8_t rgb_matrix_map_row_column_to_led(uint8_t row, uint8_t column, uint8_t *l
 void rgb_matrix_set_color(int index, uint8_t red, uint8_t green, uint8_t blue);
 void rgb_matrix_set_color_all(uint8_t red, uint8_t green, uint8_t blue);
 
+// Converts the colors computed by the effects to RGB, can be overridden by the
+// keyboard or keymap, for example to limit the brightness
+RGB rgb_matrix_hsv_to_rgb(HSV hsv);
+#ifdef RGB_MATRIX_HSV_TO_RGB_BATCH
+// Used instead of rgb_matrix_hsv_to_rgb() by the effect runners, to convert
+// count (at most RGB_MATRIX_HSV_TO_RGB_BATCH_SIZE) colors from hsv into rgb.
+// An override of rgb_matrix_hsv_to_rgb() must also override this one, and
+// convert every color the same way, as effects use both.
+void rgb_matrix_hsv_to_rgb_batch(const HSV *hsv, RGB *rgb, uint8_t count);
+#endif
+
 void rgb_matrix_handle_key_event(uint8_t row, uint8_t col, bool pressed);
 
 void rgb_matrix_task(void);
@@ -277,3 +288,20 @@ extern last_hit_t g_last_hit_tracker;
 #ifdef RGB_MATRIX_FRAMEBUFFER_EFFECTS
 extern uint8_t g_rgb_frame_buffer[MATRIX_ROWS][MATRIX_COLS];
 #endif
+
+/* The LED layout is split into tiles of 32x16 units, eight across and four
+ * down (the last row also covers anything below y = 64), so that effects can
+ * tell which LEDs are near a point without computing any distances.
+ */
+typedef uint32_t rgb_matrix_tiles_t;
+
+static inline rgb_matrix_tiles_t rgb_matrix_led_tile(uint8_t led_idx) {
+    uint8_t row = g_led_config.point[led_idx].y >> 4;
+    return (rgb_matrix_tiles_t)1 << ((row > 3 ? 3 : row) * 8 + (g_led_config.point[led_idx].x >> 5));
+}
+
+rgb_matrix_tiles_t rgb_matrix_tiles_around(uint8_t x, uint8_t y, uint8_t reach);
+
+#ifdef RGB_MATRIX_LED_POLAR_CACHE
+void rgb_matrix_update_led_polar(void);
+#endif
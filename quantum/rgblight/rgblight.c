@@ -115,6 +115,11 @@ static bool pre_suspend_enabled;
 animation_status_t animation_status = {};
 #endif
 
+#ifdef RGBLIGHT_LED_FLUSH_LIMIT
+static bool     rgblight_flush_pending = false;
+static uint16_t rgblight_flush_timer;
+#endif
+
 #ifndef LED_ARRAY
 rgb_led_t led[RGBLIGHT_LED_COUNT];
 #    define LED_ARRAY led
@@ -875,6 +880,10 @@ void rgblight_suspend(void) {
 #    endif
 
         rgblight_disable_noeeprom();
+#    ifdef RGBLIGHT_LED_FLUSH_LIMIT
+        // rgblight_task() does not run while suspended
+        rgblight_flush();
+#    endif
     }
 }
 
@@ -896,7 +905,11 @@ void rgblight_wakeup(void) {
 
 #endif
 
+#ifdef RGBLIGHT_LED_FLUSH_LIMIT
+static void rgblight_write(void) {
+#else
 void rgblight_set(void) {
+#endif
     rgb_led_t *start_led;
     uint8_t    num_leds = rgblight_ranges.clipping_num_leds;
 
@@ -941,6 +954,22 @@ void rgblight_set(void) {
     rgblight_driver.setleds(start_led, num_leds);
 }
 
+#ifdef RGBLIGHT_LED_FLUSH_LIMIT
+// Updates are only sent to the LEDs by rgblight_task(), at most once every
+// RGBLIGHT_LED_FLUSH_LIMIT milliseconds, however many were made in between
+void rgblight_set(void) {
+    rgblight_flush_pending = true;
+}
+
+void rgblight_flush(void) {
+    if (rgblight_flush_pending) {
+        rgblight_flush_pending = false;
+        rgblight_flush_timer   = timer_read();
+        rgblight_write();
+    }
+}
+#endif
+
 #ifdef RGBLIGHT_SPLIT
 /* for split keyboard master side */
 uint8_t rgblight_get_change_flags(void) {
@@ -1530,6 +1559,12 @@ void rgblight_task(void) {
         rgblight_velocikey_decelerate();
     }
 #endif
+
+#ifdef RGBLIGHT_LED_FLUSH_LIMIT
+    if (timer_elapsed(rgblight_flush_timer) >= RGBLIGHT_LED_FLUSH_LIMIT) {
+        rgblight_flush();
+    }
+#endif
 }
 
 #ifdef VELOCIKEY_ENABLE
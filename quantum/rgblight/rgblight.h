@@ -291,6 +291,9 @@ extern rgblight_ranges_t rgblight_ranges;
 /* === Low level Functions === */
 void rgblight_set(void);
 void rgblight_set_clipping_range(uint8_t start_pos, uint8_t num_leds);
+#ifdef RGBLIGHT_LED_FLUSH_LIMIT
+void rgblight_flush(void);
+#endif
 
 /* === Effects and Animations Functions === */
 /*   effect range setting */
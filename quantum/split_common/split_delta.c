@@ -0,0 +1,48 @@
+// Copyright 2024 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <string.h>
+
+#include "crc.h"
+#include "split_delta.h"
+
+bool split_delta_encode(split_delta_t *delta, const void *acked, const void *current, uint8_t length) {
+    const uint8_t *from  = acked;
+    const uint8_t *to    = current;
+    uint8_t        first = 0;
+    uint8_t        last  = length;
+
+    while (first < last && to[first] == from[first]) {
+        first++;
+    }
+    while (last > first && to[last - 1] == from[last - 1]) {
+        last--;
+    }
+
+    if (last - first > SPLIT_TRANSACTION_DELTA_SIZE) {
+        return false;
+    }
+
+    delta->offset   = first;
+    delta->length   = last - first;
+    delta->checksum = crc8(current, length);
+    memcpy(delta->data, &to[first], delta->length);
+    return true;
+}
+
+bool split_delta_apply(const split_delta_t *delta, void *buffer, uint8_t length) {
+    uint8_t *patched = buffer;
+    uint8_t  previous[SPLIT_TRANSACTION_DELTA_SIZE];
+
+    if (delta->length > SPLIT_TRANSACTION_DELTA_SIZE || delta->offset + delta->length > length) {
+        return false;
+    }
+
+    memcpy(previous, &patched[delta->offset], delta->length);
+    memcpy(&patched[delta->offset], delta->data, delta->length);
+    if (crc8(buffer, length) != delta->checksum) {
+        memcpy(&patched[delta->offset], previous, delta->length);
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,37 @@
+// Copyright 2024 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifndef SPLIT_TRANSACTION_DELTA_SIZE
+#    define SPLIT_TRANSACTION_DELTA_SIZE 4
+#endif // SPLIT_TRANSACTION_DELTA_SIZE
+
+typedef struct _split_delta_t {
+    int8_t  transaction_id;
+    uint8_t offset;
+    uint8_t length;
+    uint8_t checksum; // crc8 of the whole patched buffer
+    uint8_t data[SPLIT_TRANSACTION_DELTA_SIZE];
+} split_delta_t;
+
+/**
+ * @brief Fills in delta with the range of bytes that differ between acked and
+ * current, along with the checksum of current. The transaction id is left to
+ * the caller.
+ *
+ * @return false if the range is longer than SPLIT_TRANSACTION_DELTA_SIZE
+ */
+bool split_delta_encode(split_delta_t *delta, const void *acked, const void *current, uint8_t length);
+
+/**
+ * @brief Patches buffer with delta. The patch is undone if the result doesn't
+ * match the delta's checksum, which means that buffer had diverged from the
+ * copy the delta was made against.
+ *
+ * @return true if buffer was patched
+ */
+bool split_delta_apply(const split_delta_t *delta, void *buffer, uint8_t length);
@@ -0,0 +1,7 @@
+split_delta_DEFS := -DSPLIT_TRANSACTION_DELTA_SIZE=4
+split_delta_INC := $(QUANTUM_PATH)/split_common
+
+split_delta_SRC := \
+	$(QUANTUM_PATH)/split_common/tests/split_delta_tests.cpp \
+	$(QUANTUM_PATH)/split_common/split_delta.c \
+	$(QUANTUM_PATH)/crc.c
@@ -0,0 +1,116 @@
+// Copyright 2024 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "gtest/gtest.h"
+
+extern "C" {
+#include "split_delta.h"
+}
+
+#include <string.h>
+
+class SplitDelta : public ::testing::Test {
+   protected:
+    uint8_t acked[8] = {0, 1, 2, 3, 4, 5, 6, 7}; // master's copy of what the slave has acked
+    uint8_t slave[8] = {0, 1, 2, 3, 4, 5, 6, 7};
+
+    // Sends current to the slave as a delta, returns whether the slave acked it
+    bool sync_delta(const uint8_t *current) {
+        split_delta_t delta = {};
+
+        if (!split_delta_encode(&delta, acked, current, sizeof(acked)) || !split_delta_apply(&delta, slave, sizeof(slave))) {
+            return false;
+        }
+        memcpy(acked, current, sizeof(acked));
+        return true;
+    }
+
+    void sync_full(const uint8_t *current) {
+        memcpy(slave, current, sizeof(slave));
+        memcpy(acked, current, sizeof(acked));
+    }
+};
+
+TEST_F(SplitDelta, EncodesOnlyTheChangedRange) {
+    uint8_t       current[8] = {0, 1, 12, 3, 14, 5, 6, 7};
+    split_delta_t delta      = {};
+
+    EXPECT_TRUE(split_delta_encode(&delta, acked, current, sizeof(current)));
+    EXPECT_EQ(delta.offset, 2);
+    EXPECT_EQ(delta.length, 3);
+    EXPECT_EQ(delta.data[0], 12);
+    EXPECT_EQ(delta.data[1], 3);
+    EXPECT_EQ(delta.data[2], 14);
+
+    EXPECT_TRUE(split_delta_apply(&delta, slave, sizeof(slave)));
+    EXPECT_EQ(memcmp(slave, current, sizeof(slave)), 0);
+}
+
+TEST_F(SplitDelta, UnchangedIsAnEmptyDelta) {
+    split_delta_t delta = {};
+
+    EXPECT_TRUE(split_delta_encode(&delta, acked, acked, sizeof(acked)));
+    EXPECT_EQ(delta.length, 0);
+    EXPECT_TRUE(split_delta_apply(&delta, slave, sizeof(slave)));
+}
+
+TEST_F(SplitDelta, ChangesFurtherApartThanADeltaAreNotEncoded) {
+    uint8_t       current[8] = {10, 1, 2, 3, 4, 5, 6, 17};
+    split_delta_t delta      = {};
+
+    EXPECT_FALSE(split_delta_encode(&delta, acked, current, sizeof(current)));
+}
+
+TEST_F(SplitDelta, DivergedCopyIsLeftAsItWas) {
+    uint8_t       current[8]  = {0, 1, 12, 3, 4, 5, 6, 7};
+    uint8_t       diverged[8] = {0, 1, 2, 3, 4, 5, 6, 0};
+    split_delta_t delta       = {};
+
+    memcpy(slave, diverged, sizeof(slave));
+    EXPECT_TRUE(split_delta_encode(&delta, acked, current, sizeof(current)));
+    EXPECT_FALSE(split_delta_apply(&delta, slave, sizeof(slave)));
+    EXPECT_EQ(memcmp(slave, diverged, sizeof(slave)), 0);
+}
+
+TEST_F(SplitDelta, OutOfBoundsDeltaIsRejected) {
+    uint8_t       original[8] = {0, 1, 2, 3, 4, 5, 6, 7};
+    split_delta_t delta       = {.offset = 6, .length = 3};
+
+    EXPECT_FALSE(split_delta_apply(&delta, slave, sizeof(slave)));
+    delta = (split_delta_t){.offset = 0, .length = SPLIT_TRANSACTION_DELTA_SIZE + 1};
+    EXPECT_FALSE(split_delta_apply(&delta, slave, sizeof(slave)));
+    EXPECT_EQ(memcmp(slave, original, sizeof(slave)), 0);
+}
+
+TEST_F(SplitDelta, LostAckIsRecoveredByTheNextSync) {
+    uint8_t       first[8]  = {0, 1, 12, 3, 4, 5, 6, 7};
+    uint8_t       second[8] = {0, 1, 12, 13, 4, 5, 6, 7};
+    split_delta_t delta     = {};
+
+    // The slave applies the first patch, but the master never hears back
+    EXPECT_TRUE(split_delta_encode(&delta, acked, first, sizeof(first)));
+    EXPECT_TRUE(split_delta_apply(&delta, slave, sizeof(slave)));
+
+    // The next delta is made against the stale copy, and covers the byte the slave already has
+    EXPECT_TRUE(sync_delta(second));
+    EXPECT_EQ(memcmp(slave, second, sizeof(slave)), 0);
+}
+
+TEST_F(SplitDelta, LostAckIsRecoveredByAFullSync) {
+    uint8_t       first[8]  = {0, 1, 12, 3, 4, 5, 6, 7};
+    uint8_t       second[8] = {0, 1, 2, 3, 4, 5, 16, 7};
+    uint8_t       third[8]  = {0, 1, 2, 3, 4, 5, 16, 17};
+    split_delta_t delta     = {};
+
+    EXPECT_TRUE(split_delta_encode(&delta, acked, first, sizeof(first)));
+    EXPECT_TRUE(split_delta_apply(&delta, slave, sizeof(slave)));
+
+    // The next delta is made against the stale copy, and misses the byte the slave got wrong
+    EXPECT_FALSE(sync_delta(second));
+    EXPECT_EQ(memcmp(slave, first, sizeof(slave)), 0);
+
+    // So it is sent in full, after which deltas work again
+    sync_full(second);
+    EXPECT_TRUE(sync_delta(third));
+    EXPECT_EQ(memcmp(slave, third, sizeof(slave)), 0);
+}
@@ -21,6 +21,14 @@ enum serial_transaction_id {
     I2C_EXECUTE_CALLBACK,
 #endif // USE_I2C
 
+#ifdef SPLIT_TRANSACTION_BATCHING
+    EXCHANGE_BATCH,
+#endif // SPLIT_TRANSACTION_BATCHING
+
+#ifdef SPLIT_TRANSACTION_DELTA
+    PUT_DELTA,
+#endif // SPLIT_TRANSACTION_DELTA
+
     GET_SLAVE_MATRIX_CHECKSUM,
     GET_SLAVE_MATRIX_DATA,
 
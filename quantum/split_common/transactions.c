@@ -84,16 +84,247 @@
 #define trans_initiator2target_cb(cb) \
     { 0, 0, 0, 0, cb }
 
-#define transport_write(id, data, length) transport_execute_transaction(id, data, length, NULL, 0)
-#define transport_read(id, data, length) transport_execute_transaction(id, NULL, 0, data, length)
+#ifdef SPLIT_TRANSACTION_BATCHING
+#    if defined(USE_I2C) || defined(SERIAL_DRIVER_BITBANG)
+#        error "SPLIT_TRANSACTION_BATCHING requires SERIAL_DRIVER = usart or vendor"
+#    endif
+_Static_assert(SPLIT_TRANSACTION_BATCH_SIZE <= UINT8_MAX, "SPLIT_TRANSACTION_BATCH_SIZE must fit the frame length");
+
+static bool batch_write(int8_t id, const void *data, size_t length);
+static bool batch_read(int8_t id, void *data, size_t length);
+
+#    define transport_write(id, data, length) batch_write(id, data, length)
+#    define transport_read(id, data, length) batch_read(id, data, length)
+#else // SPLIT_TRANSACTION_BATCHING
+#    define transport_write(id, data, length) transport_execute_transaction(id, data, length, NULL, 0)
+#    define transport_read(id, data, length) transport_execute_transaction(id, NULL, 0, data, length)
+#endif // SPLIT_TRANSACTION_BATCHING
 #define transport_exec(id) transport_execute_transaction(id, NULL, 0, NULL, 0)
 
+#if defined(SPLIT_TRANSACTION_DELTA) && defined(SPLIT_TRANSACTION_BATCHING)
+#    error "SPLIT_TRANSACTION_DELTA and SPLIT_TRANSACTION_BATCHING are mutually exclusive"
+#endif
+
 #if defined(SPLIT_TRANSACTION_IDS_KB) || defined(SPLIT_TRANSACTION_IDS_USER)
 // Forward-declare the RPC callback handlers
 void slave_rpc_info_callback(uint8_t initiator2target_buffer_size, const void *initiator2target_buffer, uint8_t target2initiator_buffer_size, void *target2initiator_buffer);
 void slave_rpc_exec_callback(uint8_t initiator2target_buffer_size, const void *initiator2target_buffer, uint8_t target2initiator_buffer_size, void *target2initiator_buffer);
 #endif // defined(SPLIT_TRANSACTION_IDS_KB) || defined(SPLIT_TRANSACTION_IDS_USER)
 
+////////////////////////////////////////////////////
+// Batching
+
+#ifdef SPLIT_TRANSACTION_BATCHING
+
+/*
+ * Writes to the slave are queued up in the split shared memory and sent
+ * together in a single EXCHANGE_BATCH frame, whose reply carries every
+ * response that changed since it was last sent (or that was explicitly
+ * requested) in one go. Each frame holds a bitmask of the transaction IDs it
+ * carries, their data is packed back to back in transaction ID order. The
+ * slave acknowledges a frame by setting the EXCHANGE_BATCH bit in its reply.
+ */
+
+#    define BATCH_SECTION(id) (1UL << (id))
+#    define BATCH_ACK BATCH_SECTION(EXCHANGE_BATCH)
+
+static uint32_t batch_m2s_sections = 0; // writes that can be batched
+static uint32_t batch_s2m_sections = 0; // responses that can be batched
+static uint32_t batch_dirty        = 0; // writes queued for the next exchange
+static bool     batch_resync       = true;
+
+static void batch_sections_init(void) {
+    static bool initialised = false;
+    if (initialised) {
+        return;
+    }
+    initialised = true;
+
+    uint16_t s2m_length = 0;
+    for (int8_t id = 0; id < NUM_TOTAL_TRANSACTIONS; id++) {
+        split_transaction_desc_t *trans = &split_transaction_table[id];
+#    if defined(SPLIT_TRANSACTION_IDS_KB) || defined(SPLIT_TRANSACTION_IDS_USER)
+        // RPC transactions rely on being executed in sequence
+        if (id >= PUT_RPC_INFO && id <= GET_RPC_RESP_DATA) {
+            continue;
+        }
+#    endif // defined(SPLIT_TRANSACTION_IDS_KB) || defined(SPLIT_TRANSACTION_IDS_USER)
+        if (id == EXCHANGE_BATCH) {
+            continue;
+        }
+        if (trans->initiator2target_buffer_size && !trans->target2initiator_buffer_size) {
+            if (trans->initiator2target_buffer_size <= SPLIT_TRANSACTION_BATCH_SIZE) {
+                batch_m2s_sections |= BATCH_SECTION(id);
+            }
+        } else if (!trans->initiator2target_buffer_size && trans->target2initiator_buffer_size && !trans->slave_callback) {
+            // A reply must be able to hold all responses at once
+            if (s2m_length + trans->target2initiator_buffer_size <= SPLIT_TRANSACTION_BATCH_SIZE) {
+                batch_s2m_sections |= BATCH_SECTION(id);
+                s2m_length += trans->target2initiator_buffer_size;
+            }
+        }
+    }
+}
+
+static uint16_t batch_sections_length(uint32_t sections, bool initiator2target) {
+    uint16_t length = 0;
+    for (int8_t id = 0; id < NUM_TOTAL_TRANSACTIONS; id++) {
+        if (sections & BATCH_SECTION(id)) {
+            length += initiator2target ? split_transaction_table[id].initiator2target_buffer_size : split_transaction_table[id].target2initiator_buffer_size;
+        }
+    }
+    return length;
+}
+
+static bool batch_write(int8_t id, const void *data, size_t length) {
+    if (!(batch_m2s_sections & BATCH_SECTION(id))) {
+        return transport_execute_transaction(id, data, length, NULL, 0);
+    }
+    split_transaction_desc_t *trans = &split_transaction_table[id];
+    size_t                    len   = trans->initiator2target_buffer_size < length ? trans->initiator2target_buffer_size : length;
+    memcpy(split_trans_initiator2target_buffer(trans), data, len);
+    batch_dirty |= BATCH_SECTION(id);
+    return true;
+}
+
+static bool batch_read(int8_t id, void *data, size_t length) {
+    if (!(batch_s2m_sections & BATCH_SECTION(id))) {
+        return transport_execute_transaction(id, NULL, 0, data, length);
+    }
+    // Kept up to date by the last exchange
+    split_transaction_desc_t *trans = &split_transaction_table[id];
+    size_t                    len   = trans->target2initiator_buffer_size < length ? trans->target2initiator_buffer_size : length;
+    memcpy(data, split_trans_target2initiator_buffer(trans), len);
+    return true;
+}
+
+static bool batch_exchange(uint32_t requests) {
+    split_batch_frame_t *frame  = &split_shmem->batch_m2s;
+    uint32_t             packed = 0;
+
+    frame->length = 0;
+    for (int8_t id = 0; id < NUM_TOTAL_TRANSACTIONS; id++) {
+        if (!(batch_dirty & BATCH_SECTION(id))) {
+            continue;
+        }
+        split_transaction_desc_t *trans = &split_transaction_table[id];
+        // Anything which does not fit is left for the next frame
+        if (frame->length + trans->initiator2target_buffer_size > sizeof(frame->payload)) {
+            continue;
+        }
+        memcpy(&frame->payload[frame->length], split_trans_initiator2target_buffer(trans), trans->initiator2target_buffer_size);
+        frame->length += trans->initiator2target_buffer_size;
+        packed |= BATCH_SECTION(id);
+    }
+    frame->sections = packed | requests;
+    frame->checksum = crc8(frame->payload, frame->length);
+
+    if (!transport_exec(EXCHANGE_BATCH)) {
+        return false;
+    }
+
+    const split_batch_frame_t *reply     = &split_shmem->batch_s2m;
+    uint32_t                   responses = reply->sections & ~BATCH_ACK;
+    if (!(reply->sections & BATCH_ACK) || (responses & ~batch_s2m_sections) || reply->length != batch_sections_length(responses, false) || reply->checksum != crc8(reply->payload, reply->length)) {
+        return false;
+    }
+
+    uint8_t offset = 0;
+    for (int8_t id = 0; id < NUM_TOTAL_TRANSACTIONS; id++) {
+        if (responses & BATCH_SECTION(id)) {
+            split_transaction_desc_t *trans = &split_transaction_table[id];
+            memcpy(split_trans_target2initiator_buffer(trans), &reply->payload[offset], trans->target2initiator_buffer_size);
+            offset += trans->target2initiator_buffer_size;
+        }
+    }
+
+    batch_dirty &= ~packed;
+    return true;
+}
+
+static bool batch_handlers_master(matrix_row_t master_matrix[], matrix_row_t slave_matrix[]) {
+    static uint32_t last_update = 0;
+
+    // Ask for all responses now and again, and whenever the last replies may have been lost
+    uint32_t requests = 0;
+    if (batch_resync || timer_elapsed32(last_update) >= FORCED_SYNC_THROTTLE_MS) {
+        requests = batch_s2m_sections;
+    }
+
+    do {
+        if (!batch_exchange(requests)) {
+            batch_resync = true;
+            return false;
+        }
+        if (requests) {
+            last_update  = timer_read32();
+            batch_resync = false;
+            requests     = 0;
+        }
+    } while (batch_dirty);
+    return true;
+}
+
+static void batch_handlers_slave_exchange(uint8_t initiator2target_buffer_size, const void *initiator2target_buffer, uint8_t target2initiator_buffer_size, void *target2initiator_buffer) {
+    // Responses as they were last sent, at fixed offsets
+    static uint8_t shadow[SPLIT_TRANSACTION_BATCH_SIZE];
+
+    const split_batch_frame_t *frame = &split_shmem->batch_m2s;
+    split_batch_frame_t       *reply = &split_shmem->batch_s2m;
+    uint32_t                   writes;
+
+    batch_sections_init();
+    writes          = frame->sections & batch_m2s_sections;
+    reply->sections = 0;
+    reply->length   = 0;
+    reply->checksum = crc8(reply->payload, 0);
+    if ((frame->sections & ~(batch_m2s_sections | batch_s2m_sections)) || frame->length != batch_sections_length(writes, true) || frame->checksum != crc8(frame->payload, frame->length)) {
+        // Leave the frame unacknowledged, the master will retry
+        return;
+    }
+
+    uint8_t offset = 0;
+    for (int8_t id = 0; id < NUM_TOTAL_TRANSACTIONS; id++) {
+        if (writes & BATCH_SECTION(id)) {
+            split_transaction_desc_t *trans = &split_transaction_table[id];
+            memcpy(split_trans_initiator2target_buffer(trans), &frame->payload[offset], trans->initiator2target_buffer_size);
+            offset += trans->initiator2target_buffer_size;
+            if (trans->slave_callback) {
+                trans->slave_callback(trans->initiator2target_buffer_size, split_trans_initiator2target_buffer(trans), 0, NULL);
+            }
+        }
+    }
+
+    offset = 0;
+    for (int8_t id = 0; id < NUM_TOTAL_TRANSACTIONS; id++) {
+        if (batch_s2m_sections & BATCH_SECTION(id)) {
+            split_transaction_desc_t *trans  = &split_transaction_table[id];
+            uint8_t                  *source = split_trans_target2initiator_buffer(trans);
+            if ((frame->sections & BATCH_SECTION(id)) || memcmp(&shadow[offset], source, trans->target2initiator_buffer_size) != 0) {
+                memcpy(&shadow[offset], source, trans->target2initiator_buffer_size);
+                memcpy(&reply->payload[reply->length], source, trans->target2initiator_buffer_size);
+                reply->length += trans->target2initiator_buffer_size;
+                reply->sections |= BATCH_SECTION(id);
+            }
+            offset += trans->target2initiator_buffer_size;
+        }
+    }
+    reply->sections |= BATCH_ACK;
+    reply->checksum = crc8(reply->payload, reply->length);
+}
+
+// clang-format off
+#    define TRANSACTIONS_BATCH_MASTER() TRANSACTION_HANDLER_MASTER(batch)
+#    define TRANSACTIONS_BATCH_REGISTRATIONS \
+    [EXCHANGE_BATCH] = { offsetof(split_batch_frame_t, payload), offsetof(split_shared_memory_t, batch_m2s), offsetof(split_batch_frame_t, payload), offsetof(split_shared_memory_t, batch_s2m), batch_handlers_slave_exchange },
+// clang-format on
+
+#else // SPLIT_TRANSACTION_BATCHING
+
+#    define TRANSACTIONS_BATCH_REGISTRATIONS
+
+#endif // SPLIT_TRANSACTION_BATCHING
+
 ////////////////////////////////////////////////////
 // Helpers
 
@@ -159,10 +390,72 @@ inline static bool read_if_checksum_mismatch(int8_t trans_id_checksum, int8_t tr
     return okay;
 }
 
+#ifdef SPLIT_TRANSACTION_DELTA
+
+// Buffers whose last write was acknowledged by the slave, and can be patched
+static uint32_t delta_synced = 0;
+
+static bool delta_patchable(int8_t trans_id, size_t length) {
+#    if defined(RGBLIGHT_ENABLE) && defined(RGBLIGHT_SPLIT)
+    // The slave clears the change flags in its copy
+    if (trans_id == PUT_RGBLIGHT) {
+        return false;
+    }
+#    endif // defined(RGBLIGHT_ENABLE) && defined(RGBLIGHT_SPLIT)
+    // Patching anything smaller than a delta is a loss
+    return (delta_synced & (1UL << trans_id)) && length == split_transaction_table[trans_id].initiator2target_buffer_size && length > sizeof(split_delta_t);
+}
+
+/**
+ * @brief Sends only the range of bytes which changed since the last
+ * acknowledged write, along with a checksum of the whole buffer. Falls back to
+ * a full write if they are too far apart, or if the slave's copy turns out to
+ * have diverged.
+ */
+static bool transport_write_delta(int8_t trans_id, const void *source, size_t length) {
+    split_transaction_desc_t *trans = &split_transaction_table[trans_id];
+
+    if (delta_patchable(trans_id, length)) {
+        uint8_t      *acked = split_trans_initiator2target_buffer(trans);
+        split_delta_t delta = {.transaction_id = trans_id};
+
+        if (split_delta_encode(&delta, acked, source, length)) {
+            /* The slave acks the patch only if its copy matched ours. This
+             * costs one byte after the slave has applied the patch, but without
+             * it a slave which was reset, or missed a patch, would keep
+             * rejecting every delta until the data changed enough to be sent
+             * in full. With it, the very next sync recovers, and an unchanged
+             * forced sync can be an empty delta. */
+            bool ack = false;
+            if (!transport_execute_transaction(PUT_DELTA, &delta, sizeof(delta), &ack, sizeof(ack))) {
+                delta_synced &= ~(1UL << trans_id);
+                return false;
+            }
+            if (ack) {
+                memcpy(acked, source, length);
+                return true;
+            }
+        }
+    }
+
+    bool okay = transport_write(trans_id, source, length);
+    if (okay && length == trans->initiator2target_buffer_size) {
+        delta_synced |= (1UL << trans_id);
+    } else {
+        delta_synced &= ~(1UL << trans_id);
+    }
+    return okay;
+}
+
+#    define transport_write_sync(id, data, length) transport_write_delta(id, data, length)
+#else // SPLIT_TRANSACTION_DELTA
+#    define transport_write_sync(id, data, length) transport_write(id, data, length)
+#endif // SPLIT_TRANSACTION_DELTA
+
 inline static bool send_if_condition(int8_t trans_id, uint32_t *last_update, bool condition, void *source, size_t length) {
     bool okay = true;
     if (timer_elapsed32(*last_update) >= FORCED_SYNC_THROTTLE_MS || condition) {
-        okay &= transport_write(trans_id, source, length);
+        okay &= transport_write_sync(trans_id, source, length);
         if (okay) {
             *last_update = timer_read32();
         }
@@ -175,6 +468,46 @@ inline static bool send_if_data_mismatch(int8_t trans_id, uint32_t *last_update,
     return send_if_condition(trans_id, last_update, (memcmp(source, equiv_shmem, length) != 0), source, length);
 }
 
+////////////////////////////////////////////////////
+// Delta
+
+#ifdef SPLIT_TRANSACTION_DELTA
+
+static void delta_handlers_slave_patch(uint8_t initiator2target_buffer_size, const void *initiator2target_buffer, uint8_t target2initiator_buffer_size, void *target2initiator_buffer) {
+    const split_delta_t *delta = &split_shmem->delta;
+
+    split_shmem->delta_ack = false;
+    if (delta->transaction_id < 0 || delta->transaction_id >= NUM_TOTAL_TRANSACTIONS || delta->transaction_id == PUT_DELTA) {
+        return;
+    }
+    split_transaction_desc_t *trans = &split_transaction_table[delta->transaction_id];
+    if (trans->target2initiator_buffer_size) {
+        return;
+    }
+
+    uint8_t *buffer = split_trans_initiator2target_buffer(trans);
+    if (!split_delta_apply(delta, buffer, trans->initiator2target_buffer_size)) {
+        // Our copy has diverged, let the master resend it in full
+        return;
+    }
+
+    if (trans->slave_callback) {
+        trans->slave_callback(trans->initiator2target_buffer_size, buffer, 0, NULL);
+    }
+    split_shmem->delta_ack = true;
+}
+
+// clang-format off
+#    define TRANSACTIONS_DELTA_REGISTRATIONS \
+    [PUT_DELTA] = { sizeof_member(split_shared_memory_t, delta), offsetof(split_shared_memory_t, delta), sizeof_member(split_shared_memory_t, delta_ack), offsetof(split_shared_memory_t, delta_ack), delta_handlers_slave_patch },
+// clang-format on
+
+#else // SPLIT_TRANSACTION_DELTA
+
+#    define TRANSACTIONS_DELTA_REGISTRATIONS
+
+#endif // SPLIT_TRANSACTION_DELTA
+
 ////////////////////////////////////////////////////
 // Slave matrix
 
@@ -764,7 +1097,14 @@ static void pointing_handlers_slave(matrix_row_t master_matrix[], matrix_row_t s
         pointing_device_driver.set_cpi(pointing.cpi);
     }
 
-    pointing.report = pointing_device_driver.get_report((report_mouse_t){0});
+    // Without motion, publish an empty report, as the master applies the last one it received until it changes
+    pointing.report = (report_mouse_t){.buttons = pointing.report.buttons};
+#    ifdef POINTING_DEVICE_MOTION_PIN
+    if (pointing_device_motion_detected())
+#    endif
+    {
+        pointing.report = pointing_device_driver.get_report((report_mouse_t){0});
+    }
     // Now update the checksum given that the pointing has been written to
     pointing.checksum = crc8(&pointing.report, sizeof(report_mouse_t));
 
@@ -925,6 +1265,8 @@ split_transaction_desc_t split_transaction_table[NUM_TOTAL_TRANSACTIONS] = {
 #endif // USE_I2C
 
     // clang-format off
+    TRANSACTIONS_BATCH_REGISTRATIONS
+    TRANSACTIONS_DELTA_REGISTRATIONS
     TRANSACTIONS_SLAVE_MATRIX_REGISTRATIONS
     TRANSACTIONS_MASTER_MATRIX_REGISTRATIONS
     TRANSACTIONS_ENCODERS_REGISTRATIONS
@@ -955,6 +1297,31 @@ split_transaction_desc_t split_transaction_table[NUM_TOTAL_TRANSACTIONS] = {
 };
 
 bool transactions_master(matrix_row_t master_matrix[], matrix_row_t slave_matrix[]) {
+#ifdef SPLIT_TRANSACTION_BATCHING
+    // Queue up all writes first, exchange them in one go, then consume the responses
+    batch_sections_init();
+    TRANSACTIONS_MASTER_MATRIX_MASTER();
+    TRANSACTIONS_SYNC_TIMER_MASTER();
+    TRANSACTIONS_LAYER_STATE_MASTER();
+    TRANSACTIONS_LED_STATE_MASTER();
+    TRANSACTIONS_MODS_MASTER();
+    TRANSACTIONS_BACKLIGHT_MASTER();
+    TRANSACTIONS_RGBLIGHT_MASTER();
+    TRANSACTIONS_LED_MATRIX_MASTER();
+    TRANSACTIONS_RGB_MATRIX_MASTER();
+    TRANSACTIONS_WPM_MASTER();
+    TRANSACTIONS_OLED_MASTER();
+    TRANSACTIONS_ST7565_MASTER();
+    TRANSACTIONS_WATCHDOG_MASTER();
+    TRANSACTIONS_HAPTIC_MASTER();
+    TRANSACTIONS_ACTIVITY_MASTER();
+    TRANSACTIONS_DETECTED_OS_MASTER();
+    TRANSACTIONS_BATCH_MASTER();
+    TRANSACTIONS_SLAVE_MATRIX_MASTER();
+    TRANSACTIONS_ENCODERS_MASTER();
+    TRANSACTIONS_POINTING_MASTER();
+    return true;
+#else  // SPLIT_TRANSACTION_BATCHING
     TRANSACTIONS_SLAVE_MATRIX_MASTER();
     TRANSACTIONS_MASTER_MATRIX_MASTER();
     TRANSACTIONS_ENCODERS_MASTER();
@@ -975,6 +1342,7 @@ bool transactions_master(matrix_row_t master_matrix[], matrix_row_t slave_matrix
     TRANSACTIONS_ACTIVITY_MASTER();
     TRANSACTIONS_DETECTED_OS_MASTER();
     return true;
+#endif // SPLIT_TRANSACTION_BATCHING
 }
 
 void transactions_slave(matrix_row_t master_matrix[], matrix_row_t slave_matrix[]) {
@@ -147,6 +147,24 @@ typedef struct _rpc_sync_info_t {
 #    include "os_detection.h"
 #endif // defined(OS_DETECTION_ENABLE) && defined(SPLIT_DETECTED_OS_ENABLE)
 
+#ifdef SPLIT_TRANSACTION_BATCHING
+#    ifndef SPLIT_TRANSACTION_BATCH_SIZE
+#        define SPLIT_TRANSACTION_BATCH_SIZE 64
+#    endif // SPLIT_TRANSACTION_BATCH_SIZE
+
+// Only the header and the used part of the payload are sent over the wire
+typedef struct _split_batch_frame_t {
+    uint32_t sections; // bitmask of transaction IDs carried by, or requested from, this frame
+    uint8_t  length;
+    uint8_t  checksum;
+    uint8_t  payload[SPLIT_TRANSACTION_BATCH_SIZE];
+} split_batch_frame_t;
+#endif // SPLIT_TRANSACTION_BATCHING
+
+#ifdef SPLIT_TRANSACTION_DELTA
+#    include "split_delta.h"
+#endif // SPLIT_TRANSACTION_DELTA
+
 typedef struct _split_shared_memory_t {
 #ifdef USE_I2C
     int8_t transaction_id;
@@ -231,6 +249,16 @@ typedef struct _split_shared_memory_t {
 #if defined(OS_DETECTION_ENABLE) && defined(SPLIT_DETECTED_OS_ENABLE)
     os_variant_t detected_os;
 #endif // defined(OS_DETECTION_ENABLE) && defined(SPLIT_DETECTED_OS_ENABLE)
+
+#ifdef SPLIT_TRANSACTION_BATCHING
+    split_batch_frame_t batch_m2s;
+    split_batch_frame_t batch_s2m;
+#endif // SPLIT_TRANSACTION_BATCHING
+
+#ifdef SPLIT_TRANSACTION_DELTA
+    split_delta_t delta;
+    bool          delta_ack;
+#endif // SPLIT_TRANSACTION_DELTA
 } split_shared_memory_t;
 
 extern split_shared_memory_t *const split_shmem;
@@ -0,0 +1,278 @@
+// Copyright 2024 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <string.h>
+#include "task_profiling.h"
+#include "timer.h"
+#include "print.h"
+#include "debug.h"
+#include "util.h"
+
+static task_profiling_stats_t task_profiling_table[TASK_PROFILE_ID_COUNT];
+
+// clang-format off
+static const char *const task_profiling_names[TASK_PROFILE_ID_COUNT] = {
+    [TASK_PROFILE_ID_KEYBOARD_TASK]           = "keyboard_task",
+    [TASK_PROFILE_ID_MATRIX_TASK]             = "matrix_task",
+    [TASK_PROFILE_ID_QUANTUM_TASK]            = "quantum_task",
+#if defined(AUDIO_ENABLE) && !defined(NO_MUSIC_MODE)
+    [TASK_PROFILE_ID_MUSIC_TASK]              = "music_task",
+#endif
+#ifdef KEY_OVERRIDE_ENABLE
+    [TASK_PROFILE_ID_KEY_OVERRIDE_TASK]       = "key_override_task",
+#endif
+#ifdef SEQUENCER_ENABLE
+    [TASK_PROFILE_ID_SEQUENCER_TASK]          = "sequencer_task",
+#endif
+#ifdef TAP_DANCE_ENABLE
+    [TASK_PROFILE_ID_TAP_DANCE_TASK]          = "tap_dance_task",
+#endif
+#ifdef COMBO_ENABLE
+    [TASK_PROFILE_ID_COMBO_TASK]              = "combo_task",
+#endif
+#ifdef LEADER_ENABLE
+    [TASK_PROFILE_ID_LEADER_TASK]             = "leader_task",
+#endif
+#ifdef WPM_ENABLE
+    [TASK_PROFILE_ID_DECAY_WPM]               = "decay_wpm",
+#endif
+#ifdef DIP_SWITCH_ENABLE
+    [TASK_PROFILE_ID_DIP_SWITCH_TASK]         = "dip_switch_task",
+#endif
+#ifdef AUTO_SHIFT_ENABLE
+    [TASK_PROFILE_ID_AUTOSHIFT_MATRIX_SCAN]   = "autoshift_matrix_scan",
+#endif
+#ifdef CAPS_WORD_ENABLE
+    [TASK_PROFILE_ID_CAPS_WORD_TASK]          = "caps_word_task",
+#endif
+#ifdef SECURE_ENABLE
+    [TASK_PROFILE_ID_SECURE_TASK]             = "secure_task",
+#endif
+#ifdef SPLIT_WATCHDOG_ENABLE
+    [TASK_PROFILE_ID_SPLIT_WATCHDOG_TASK]     = "split_watchdog_task",
+#endif
+#ifdef RGBLIGHT_ENABLE
+    [TASK_PROFILE_ID_RGBLIGHT_TASK]           = "rgblight_task",
+#endif
+#ifdef LED_MATRIX_ENABLE
+    [TASK_PROFILE_ID_LED_MATRIX_TASK]         = "led_matrix_task",
+#endif
+#ifdef RGB_MATRIX_ENABLE
+    [TASK_PROFILE_ID_RGB_MATRIX_TASK]         = "rgb_matrix_task",
+#endif
+#if defined(BACKLIGHT_ENABLE) && (defined(BACKLIGHT_PIN) || defined(BACKLIGHT_PINS))
+    [TASK_PROFILE_ID_BACKLIGHT_TASK]          = "backlight_task",
+#endif
+#ifdef ENCODER_ENABLE
+    [TASK_PROFILE_ID_ENCODER_TASK]            = "encoder_task",
+#endif
+#ifdef POINTING_DEVICE_ENABLE
+    [TASK_PROFILE_ID_POINTING_DEVICE_TASK]    = "pointing_device_task",
+#endif
+#ifdef OLED_ENABLE
+    [TASK_PROFILE_ID_OLED_TASK]               = "oled_task",
+#endif
+#ifdef ST7565_ENABLE
+    [TASK_PROFILE_ID_ST7565_TASK]             = "st7565_task",
+#endif
+#ifdef MOUSEKEY_ENABLE
+    [TASK_PROFILE_ID_MOUSEKEY_TASK]           = "mousekey_task",
+#endif
+#ifdef PS2_MOUSE_ENABLE
+    [TASK_PROFILE_ID_PS2_MOUSE_TASK]          = "ps2_mouse_task",
+#endif
+#ifdef MIDI_ENABLE
+    [TASK_PROFILE_ID_MIDI_TASK]               = "midi_task",
+#endif
+#ifdef JOYSTICK_ENABLE
+    [TASK_PROFILE_ID_JOYSTICK_TASK]           = "joystick_task",
+#endif
+#ifdef BLUETOOTH_ENABLE
+    [TASK_PROFILE_ID_BLUETOOTH_TASK]          = "bluetooth_task",
+#endif
+#ifdef HAPTIC_ENABLE
+    [TASK_PROFILE_ID_HAPTIC_TASK]             = "haptic_task",
+#endif
+    [TASK_PROFILE_ID_LED_TASK]                = "led_task",
+#ifdef OS_DETECTION_ENABLE
+    [TASK_PROFILE_ID_OS_DETECTION_TASK]       = "os_detection_task",
+#endif
+    [TASK_PROFILE_ID_HOUSEKEEPING_TASK]       = "housekeeping_task",
+};
+// clang-format on
+
+static uint8_t task_profiling_bucket(uint32_t cycles) {
+    // Bucket n holds samples in the range [2^(n-1), 2^n)
+    uint8_t bucket = 0;
+    while (cycles) {
+        cycles >>= 1;
+        ++bucket;
+    }
+    return MIN(bucket, TASK_PROFILING_HISTOGRAM_BUCKETS - 1);
+}
+
+void task_profiling_record(uint8_t slot, uint32_t cycles) {
+    if (slot >= TASK_PROFILE_ID_COUNT) {
+        return;
+    }
+
+    task_profiling_stats_t *stats = &task_profiling_table[slot];
+    if (stats->count == 0 || cycles < stats->min) {
+        stats->min = cycles;
+    }
+    if (cycles > stats->max) {
+        stats->max = cycles;
+    }
+    stats->last = cycles;
+    stats->count++;
+
+    uint8_t bucket = task_profiling_bucket(cycles);
+    if (stats->histogram[bucket] == UINT16_MAX) {
+        // Halve every bucket so the distribution keeps its shape, biased towards recent samples
+        for (uint8_t i = 0; i < TASK_PROFILING_HISTOGRAM_BUCKETS; ++i) {
+            stats->histogram[i] >>= 1;
+        }
+    }
+    stats->histogram[bucket]++;
+}
+
+const task_profiling_stats_t *task_profiling_get_stats(uint8_t slot) {
+    if (slot >= TASK_PROFILE_ID_COUNT) {
+        return NULL;
+    }
+    return &task_profiling_table[slot];
+}
+
+uint32_t task_profiling_get_percentile(uint8_t slot, uint8_t percentile) {
+    if (slot >= TASK_PROFILE_ID_COUNT) {
+        return 0;
+    }
+
+    const task_profiling_stats_t *stats = &task_profiling_table[slot];
+
+    uint32_t total = 0;
+    for (uint8_t i = 0; i < TASK_PROFILING_HISTOGRAM_BUCKETS; ++i) {
+        total += stats->histogram[i];
+    }
+    if (total == 0) {
+        return 0;
+    }
+
+    uint32_t threshold  = (total * MIN(percentile, 100) + 99) / 100;
+    uint32_t cumulative = 0;
+    for (uint8_t i = 0; i < TASK_PROFILING_HISTOGRAM_BUCKETS; ++i) {
+        cumulative += stats->histogram[i];
+        if (cumulative >= threshold) {
+            uint32_t upper_bound = (i >= 32) ? UINT32_MAX : ((1UL << i) - 1);
+            return MIN(MAX(upper_bound, stats->min), stats->max);
+        }
+    }
+    return stats->max;
+}
+
+const char *task_profiling_get_name(uint8_t slot) {
+#ifdef SPLIT_KEYBOARD
+    if (slot >= TASK_PROFILE_ID_SPLIT_TRANSACTION_BASE && slot < TASK_PROFILE_ID_COUNT) {
+        return "split_transaction";
+    }
+#endif
+    if (slot >= TASK_PROFILE_ID_COUNT || task_profiling_names[slot] == NULL) {
+        return "unknown";
+    }
+    return task_profiling_names[slot];
+}
+
+void task_profiling_reset(void) {
+    memset(task_profiling_table, 0, sizeof(task_profiling_table));
+}
+
+void task_profiling_print(void) {
+    xprintf("%-24s %10s %10s %10s %10s\n", "task", "count", "min", "max", "p99");
+    for (uint8_t slot = 0; slot < TASK_PROFILE_ID_COUNT; ++slot) {
+        const task_profiling_stats_t *stats = &task_profiling_table[slot];
+        if (stats->count == 0) {
+            continue;
+        }
+#ifdef SPLIT_KEYBOARD
+        if (slot >= TASK_PROFILE_ID_SPLIT_TRANSACTION_BASE) {
+            xprintf("split_transaction[%2u]    ", (unsigned)(slot - TASK_PROFILE_ID_SPLIT_TRANSACTION_BASE));
+        } else
+#endif
+        {
+            xprintf("%-24s ", task_profiling_get_name(slot));
+        }
+        xprintf("%10lu %10lu %10lu %10lu\n", (unsigned long)stats->count, (unsigned long)stats->min, (unsigned long)stats->max, (unsigned long)task_profiling_get_percentile(slot, 99));
+    }
+}
+
+void task_profiling_task(void) {
+#if defined(TASK_PROFILING_PRINT_INTERVAL_MS) && TASK_PROFILING_PRINT_INTERVAL_MS > 0
+    static uint32_t last_print = 0;
+    if (timer_elapsed32(last_print) >= TASK_PROFILING_PRINT_INTERVAL_MS) {
+        last_print = timer_read32();
+        if (debug_enable) {
+            task_profiling_print();
+        }
+    }
+#endif
+}
+
+static void task_profiling_pack_u32(uint8_t *dest, uint32_t value) {
+    dest[0] = value & 0xFF;
+    dest[1] = (value >> 8) & 0xFF;
+    dest[2] = (value >> 16) & 0xFF;
+    dest[3] = (value >> 24) & 0xFF;
+}
+
+/*
+ * Raw HID protocol, all multi-byte values are little-endian:
+ *
+ *   request:  [TASK_PROFILING_RAW_HID_COMMAND_ID, command, slot]
+ *   response: [TASK_PROFILING_RAW_HID_COMMAND_ID, command, slot, payload...]
+ *
+ *   GET_SLOT_COUNT -> payload: slot count (1 byte)
+ *   GET_SLOT_STATS -> payload: count, min, max, last, p50, p99 (4 bytes each)
+ *   RESET          -> no payload
+ *
+ * Unknown commands or out of range slots are answered with 0xFF in the
+ * command byte.
+ */
+bool task_profiling_raw_hid_receive(uint8_t *data, uint8_t length) {
+    if (length < 3 || data[0] != TASK_PROFILING_RAW_HID_COMMAND_ID) {
+        return false;
+    }
+
+    uint8_t *command = &data[1];
+    uint8_t  slot    = data[2];
+    uint8_t *payload = &data[3];
+    uint8_t  space   = length - 3;
+
+    memset(payload, 0, space);
+
+    switch (*command) {
+        case TASK_PROFILING_RAW_HID_GET_SLOT_COUNT:
+            if (space >= 1) {
+                payload[0] = TASK_PROFILE_ID_COUNT;
+                return true;
+            }
+            break;
+        case TASK_PROFILING_RAW_HID_GET_SLOT_STATS:
+            if (slot < TASK_PROFILE_ID_COUNT && space >= 6 * sizeof(uint32_t)) {
+                const task_profiling_stats_t *stats = &task_profiling_table[slot];
+                task_profiling_pack_u32(&payload[0], stats->count);
+                task_profiling_pack_u32(&payload[4], stats->min);
+                task_profiling_pack_u32(&payload[8], stats->max);
+                task_profiling_pack_u32(&payload[12], stats->last);
+                task_profiling_pack_u32(&payload[16], task_profiling_get_percentile(slot, 50));
+                task_profiling_pack_u32(&payload[20], task_profiling_get_percentile(slot, 99));
+                return true;
+            }
+            break;
+        case TASK_PROFILING_RAW_HID_RESET:
+            task_profiling_reset();
+            return true;
+    }
+
+    *command = 0xFF;
+    return true;
+}
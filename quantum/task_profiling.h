@@ -0,0 +1,222 @@
+// Copyright 2024 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/*
+    This API records how long each stage of the main loop takes, in units of
+    the platform cycle counter (see cycle_counter.h).
+
+    Every instrumented stage owns a slot in a fixed RAM table, which keeps a
+    sample count, min, max, most recent value and a log2 histogram used to
+    estimate percentiles. The table can be dumped over console, or queried
+    over raw HID through task_profiling_raw_hid_receive().
+
+    Usage example:
+
+        TASK_PROFILE(MATRIX_TASK, matrix_task());
+*/
+
+#ifndef TASK_PROFILING_HISTOGRAM_BUCKETS
+#    define TASK_PROFILING_HISTOGRAM_BUCKETS 24
+#endif
+
+#ifndef TASK_PROFILING_RAW_HID_COMMAND_ID
+#    define TASK_PROFILING_RAW_HID_COMMAND_ID 0xCF
+#endif
+
+#ifdef SPLIT_KEYBOARD
+#    include "transaction_id_define.h"
+#endif
+#ifdef TASK_PROFILING_ENABLE
+#    include "cycle_counter.h"
+#endif
+
+enum task_profiling_slot {
+    TASK_PROFILE_ID_KEYBOARD_TASK,
+    TASK_PROFILE_ID_MATRIX_TASK,
+    TASK_PROFILE_ID_QUANTUM_TASK,
+
+#if defined(AUDIO_ENABLE) && !defined(NO_MUSIC_MODE)
+    TASK_PROFILE_ID_MUSIC_TASK,
+#endif
+#ifdef KEY_OVERRIDE_ENABLE
+    TASK_PROFILE_ID_KEY_OVERRIDE_TASK,
+#endif
+#ifdef SEQUENCER_ENABLE
+    TASK_PROFILE_ID_SEQUENCER_TASK,
+#endif
+#ifdef TAP_DANCE_ENABLE
+    TASK_PROFILE_ID_TAP_DANCE_TASK,
+#endif
+#ifdef COMBO_ENABLE
+    TASK_PROFILE_ID_COMBO_TASK,
+#endif
+#ifdef LEADER_ENABLE
+    TASK_PROFILE_ID_LEADER_TASK,
+#endif
+#ifdef WPM_ENABLE
+    TASK_PROFILE_ID_DECAY_WPM,
+#endif
+#ifdef DIP_SWITCH_ENABLE
+    TASK_PROFILE_ID_DIP_SWITCH_TASK,
+#endif
+#ifdef AUTO_SHIFT_ENABLE
+    TASK_PROFILE_ID_AUTOSHIFT_MATRIX_SCAN,
+#endif
+#ifdef CAPS_WORD_ENABLE
+    TASK_PROFILE_ID_CAPS_WORD_TASK,
+#endif
+#ifdef SECURE_ENABLE
+    TASK_PROFILE_ID_SECURE_TASK,
+#endif
+#ifdef SPLIT_WATCHDOG_ENABLE
+    TASK_PROFILE_ID_SPLIT_WATCHDOG_TASK,
+#endif
+#ifdef RGBLIGHT_ENABLE
+    TASK_PROFILE_ID_RGBLIGHT_TASK,
+#endif
+#ifdef LED_MATRIX_ENABLE
+    TASK_PROFILE_ID_LED_MATRIX_TASK,
+#endif
+#ifdef RGB_MATRIX_ENABLE
+    TASK_PROFILE_ID_RGB_MATRIX_TASK,
+#endif
+#if defined(BACKLIGHT_ENABLE) && (defined(BACKLIGHT_PIN) || defined(BACKLIGHT_PINS))
+    TASK_PROFILE_ID_BACKLIGHT_TASK,
+#endif
+#ifdef ENCODER_ENABLE
+    TASK_PROFILE_ID_ENCODER_TASK,
+#endif
+#ifdef POINTING_DEVICE_ENABLE
+    TASK_PROFILE_ID_POINTING_DEVICE_TASK,
+#endif
+#ifdef OLED_ENABLE
+    TASK_PROFILE_ID_OLED_TASK,
+#endif
+#ifdef ST7565_ENABLE
+    TASK_PROFILE_ID_ST7565_TASK,
+#endif
+#ifdef MOUSEKEY_ENABLE
+    TASK_PROFILE_ID_MOUSEKEY_TASK,
+#endif
+#ifdef PS2_MOUSE_ENABLE
+    TASK_PROFILE_ID_PS2_MOUSE_TASK,
+#endif
+#ifdef MIDI_ENABLE
+    TASK_PROFILE_ID_MIDI_TASK,
+#endif
+#ifdef JOYSTICK_ENABLE
+    TASK_PROFILE_ID_JOYSTICK_TASK,
+#endif
+#ifdef BLUETOOTH_ENABLE
+    TASK_PROFILE_ID_BLUETOOTH_TASK,
+#endif
+#ifdef HAPTIC_ENABLE
+    TASK_PROFILE_ID_HAPTIC_TASK,
+#endif
+    TASK_PROFILE_ID_LED_TASK,
+#ifdef OS_DETECTION_ENABLE
+    TASK_PROFILE_ID_OS_DETECTION_TASK,
+#endif
+    TASK_PROFILE_ID_HOUSEKEEPING_TASK,
+
+#ifdef SPLIT_KEYBOARD
+    // One slot per split transaction, indexed by transaction ID
+    TASK_PROFILE_ID_SPLIT_TRANSACTION_BASE,
+    TASK_PROFILE_ID_SPLIT_TRANSACTION_LAST = TASK_PROFILE_ID_SPLIT_TRANSACTION_BASE + NUM_TOTAL_TRANSACTIONS - 1,
+#endif
+
+    TASK_PROFILE_ID_COUNT
+};
+
+typedef struct task_profiling_stats_t {
+    uint32_t count;
+    uint32_t min;
+    uint32_t max;
+    uint32_t last;
+    uint16_t histogram[TASK_PROFILING_HISTOGRAM_BUCKETS];
+} task_profiling_stats_t;
+
+enum task_profiling_raw_hid_command {
+    TASK_PROFILING_RAW_HID_GET_SLOT_COUNT = 0x00,
+    TASK_PROFILING_RAW_HID_GET_SLOT_STATS = 0x01,
+    TASK_PROFILING_RAW_HID_RESET          = 0x02,
+};
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#ifdef TASK_PROFILING_ENABLE
+
+/**
+ * @brief Adds a single sample to the given slot.
+ */
+void task_profiling_record(uint8_t slot, uint32_t cycles);
+
+/**
+ * @brief Retrieves the statistics for the given slot, or NULL if out of range.
+ */
+const task_profiling_stats_t *task_profiling_get_stats(uint8_t slot);
+
+/**
+ * @brief Estimates the given percentile (0-100) of the samples recorded for a
+ * slot. The result is the upper bound of the matching histogram bucket,
+ * clamped to the observed maximum.
+ */
+uint32_t task_profiling_get_percentile(uint8_t slot, uint8_t percentile);
+
+/**
+ * @brief Retrieves the human-readable name of a slot.
+ */
+const char *task_profiling_get_name(uint8_t slot);
+
+/**
+ * @brief Clears all recorded samples.
+ */
+void task_profiling_reset(void);
+
+/**
+ * @brief Dumps the table over console.
+ */
+void task_profiling_print(void);
+
+/**
+ * @brief Periodically dumps the table over console, if
+ * TASK_PROFILING_PRINT_INTERVAL_MS is defined.
+ */
+void task_profiling_task(void);
+
+/**
+ * @brief Handles a task profiling query received over raw HID.
+ *
+ * The response is written back into the same buffer, mirroring the VIA
+ * protocol. Returns false if the report was not a task profiling command.
+ */
+bool task_profiling_raw_hid_receive(uint8_t *data, uint8_t length);
+
+#    define TASK_PROFILE_SLOT(slot, call)                                             \
+        do {                                                                          \
+            const uint32_t task_profile_start = cycle_counter_read();                 \
+            call;                                                                     \
+            task_profiling_record((slot), cycle_counter_read() - task_profile_start); \
+        } while (0)
+
+#else
+
+#    define TASK_PROFILE_SLOT(slot, call) \
+        do {                              \
+            call;                         \
+        } while (0)
+
+#endif // TASK_PROFILING_ENABLE
+
+#define TASK_PROFILE(id, call) TASK_PROFILE_SLOT(TASK_PROFILE_ID_##id, call)
+
+#ifdef __cplusplus
+}
+#endif
@@ -33,6 +33,10 @@
 #include "wait.h"
 #include "version.h" // for QMK_BUILDDATE used in EEPROM magic
 
+#if defined(TASK_PROFILING_ENABLE)
+#    include "task_profiling.h"
+#endif
+
 #if defined(AUDIO_ENABLE)
 #    include "audio.h"
 #endif
@@ -286,6 +290,13 @@ void raw_hid_receive(uint8_t *data, uint8_t length) {
         return;
     }
 
+#ifdef TASK_PROFILING_ENABLE
+    if (task_profiling_raw_hid_receive(data, length)) {
+        raw_hid_send(data, length);
+        return;
+    }
+#endif
+
     switch (*command_id) {
         case id_get_protocol_version: {
             command_data[0] = VIA_PROTOCOL_VERSION >> 8;
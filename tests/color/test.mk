@@ -0,0 +1,6 @@
+# Copyright 2024 QMK
+# SPDX-License-Identifier: GPL-2.0-or-later
+
+SRC += $(QUANTUM_DIR)/color.c
+
+CIE1931_CURVE = yes
@@ -0,0 +1,114 @@
+// Copyright 2024 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <iostream>
+#include "gtest/gtest.h"
+
+extern "C" {
+#include "color.h"
+#include "led_tables.h"
+}
+
+/* The conversion as it was before the branch-free rewrite, which the new one
+ * must match exactly. */
+static RGB reference_hsv_to_rgb(HSV hsv, bool use_cie) {
+    RGB      rgb;
+    uint8_t  region, remainder, p, q, t;
+    uint16_t h, s, v;
+
+    v = use_cie ? CIE1931_CURVE[hsv.v] : hsv.v;
+    if (hsv.s == 0) {
+        rgb.r = rgb.g = rgb.b = v;
+        return rgb;
+    }
+
+    h = hsv.h;
+    s = hsv.s;
+
+    region    = h * 6 / 255;
+    remainder = (h * 2 - region * 85) * 3;
+
+    p = (v * (255 - s)) >> 8;
+    q = (v * (255 - ((s * remainder) >> 8))) >> 8;
+    t = (v * (255 - ((s * (255 - remainder)) >> 8))) >> 8;
+
+    switch (region) {
+        case 6:
+        case 0:
+            rgb.r = v, rgb.g = t, rgb.b = p;
+            break;
+        case 1:
+            rgb.r = q, rgb.g = v, rgb.b = p;
+            break;
+        case 2:
+            rgb.r = p, rgb.g = v, rgb.b = t;
+            break;
+        case 3:
+            rgb.r = p, rgb.g = q, rgb.b = v;
+            break;
+        case 4:
+            rgb.r = t, rgb.g = p, rgb.b = v;
+            break;
+        default:
+            rgb.r = v, rgb.g = p, rgb.b = q;
+            break;
+    }
+    return rgb;
+}
+
+static bool operator==(const RGB &a, const RGB &b) {
+    return a.r == b.r && a.g == b.g && a.b == b.b;
+}
+
+static std::ostream &operator<<(std::ostream &os, const RGB &rgb) {
+    return os << "RGB(" << +rgb.r << ", " << +rgb.g << ", " << +rgb.b << ")";
+}
+
+static std::ostream &operator<<(std::ostream &os, const HSV &hsv) {
+    return os << "HSV(" << +hsv.h << ", " << +hsv.s << ", " << +hsv.v << ")";
+}
+
+/* Every color, ordered by hue, saturation and value */
+static HSV hsv_from_index(uint32_t i) {
+    return (HSV){(uint8_t)(i >> 16), (uint8_t)(i >> 8), (uint8_t)i};
+}
+
+TEST(Color, MatchesReference) {
+    for (uint32_t i = 0; i < 1UL << 24; i++) {
+        HSV hsv = hsv_from_index(i);
+        /* Compared first, so that millions of assertions are not built */
+        if (!(hsv_to_rgb_nocie(hsv) == reference_hsv_to_rgb(hsv, false)) || !(hsv_to_rgb(hsv) == reference_hsv_to_rgb(hsv, true))) {
+            ASSERT_EQ(hsv_to_rgb_nocie(hsv), reference_hsv_to_rgb(hsv, false)) << hsv;
+            ASSERT_EQ(hsv_to_rgb(hsv), reference_hsv_to_rgb(hsv, true)) << hsv;
+        }
+    }
+}
+
+TEST(Color, BatchMatchesSingle) {
+    static HSV hsv[1UL << 16];
+    static RGB rgb[1UL << 16];
+
+    for (uint32_t h = 0; h < 256; h++) {
+        for (uint32_t i = 0; i < 1UL << 16; i++) {
+            hsv[i] = hsv_from_index((h << 16) | i);
+        }
+        hsv_to_rgb_batch(hsv, rgb, 1UL << 15);
+        hsv_to_rgb_batch(&hsv[1UL << 15], &rgb[1UL << 15], 1UL << 15);
+        for (uint32_t i = 0; i < 1UL << 16; i++) {
+            if (!(rgb[i] == hsv_to_rgb(hsv[i]))) {
+                ASSERT_EQ(rgb[i], hsv_to_rgb(hsv[i])) << hsv[i];
+            }
+        }
+    }
+}
+
+TEST(Color, BatchStopsAtCount) {
+    HSV hsv[4] = {{0, 255, 255}, {85, 255, 255}, {170, 255, 255}, {0, 0, 255}};
+    RGB rgb[4] = {};
+
+    hsv_to_rgb_batch(hsv, rgb, 2);
+    EXPECT_EQ(rgb[0], hsv_to_rgb(hsv[0]));
+    EXPECT_EQ(rgb[1], hsv_to_rgb(hsv[1]));
+    EXPECT_EQ(rgb[2], (RGB){});
+    EXPECT_EQ(rgb[3], (RGB){});
+}
@@ -0,0 +1,12 @@
+// Copyright 2024 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include "test_common.h"
+
+#define COMBO_INDEX
+
+// Every pair of KC_A..KC_Y
+#define COMBO_BENCHMARK_KEYS 25
+#define COMBO_BENCHMARK_COUNT (COMBO_BENCHMARK_KEYS * (COMBO_BENCHMARK_KEYS - 1) / 2)
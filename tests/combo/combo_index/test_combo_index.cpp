@@ -0,0 +1,160 @@
+// Copyright 2024 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include "keyboard_report_util.hpp"
+#include "keycode.h"
+#include "test_common.h"
+#include "test_driver.hpp"
+#include "test_fixture.hpp"
+#include "test_keymap_key.hpp"
+
+using testing::_;
+using testing::AnyNumber;
+using testing::InSequence;
+
+extern "C" {
+#include "quantum.h"
+#include "keymap_introspection.h"
+
+extern uint16_t combo_benchmark_keys[COMBO_BENCHMARK_COUNT][3];
+extern combo_t  key_combos[COMBO_BENCHMARK_COUNT];
+
+static uint16_t combo_benchmark_count   = COMBO_BENCHMARK_COUNT;
+static uint32_t combo_benchmark_lookups = 0;
+
+uint16_t combo_count(void) {
+    return combo_benchmark_count;
+}
+
+combo_t *combo_get(uint16_t combo_idx) {
+    combo_benchmark_lookups++;
+    return combo_get_raw(combo_idx);
+}
+}
+
+class ComboIndex : public TestFixture {
+   protected:
+    ComboIndex() {
+        uint16_t idx = 0;
+        for (uint16_t a = KC_A; a < KC_A + COMBO_BENCHMARK_KEYS; a++) {
+            for (uint16_t b = a + 1; b < KC_A + COMBO_BENCHMARK_KEYS; b++) {
+                combo_benchmark_keys[idx][0] = a;
+                combo_benchmark_keys[idx][1] = b;
+                combo_benchmark_keys[idx][2] = COMBO_END;
+                key_combos[idx]              = (combo_t){.keys = combo_benchmark_keys[idx], .keycode = KC_1};
+                idx++;
+            }
+        }
+        combo_benchmark_count = COMBO_BENCHMARK_COUNT;
+        combo_index_invalidate();
+
+        set_keymap({});
+        for (uint16_t keycode = KC_A; keycode <= KC_Z; keycode++) {
+            add_key(key_for(keycode));
+        }
+    }
+
+    static KeymapKey key_for(uint16_t keycode) {
+        return KeymapKey(0, (keycode - KC_A) % MATRIX_COLS, (keycode - KC_A) / MATRIX_COLS, keycode);
+    }
+};
+
+TEST_F(ComboIndex, combo_fires) {
+    TestDriver driver;
+    KeymapKey  key_x = key_for(KC_X);
+    KeymapKey  key_y = key_for(KC_Y);
+
+    EXPECT_REPORT(driver, (KC_1));
+    EXPECT_EMPTY_REPORT(driver);
+    tap_combo({key_x, key_y});
+    VERIFY_AND_CLEAR(driver);
+}
+
+TEST_F(ComboIndex, combo_key_alone) {
+    TestDriver driver;
+    KeymapKey  key_a = key_for(KC_A);
+
+    EXPECT_REPORT(driver, (KC_A));
+    EXPECT_EMPTY_REPORT(driver);
+    tap_key(key_a);
+    VERIFY_AND_CLEAR(driver);
+}
+
+TEST_F(ComboIndex, non_combo_key_bypasses_combos) {
+    TestDriver driver;
+    KeymapKey  key_z = key_for(KC_Z);
+
+    EXPECT_REPORT(driver, (KC_Z));
+    key_z.press();
+    run_one_scan_loop();
+    VERIFY_AND_CLEAR(driver);
+
+    EXPECT_EMPTY_REPORT(driver);
+    key_z.release();
+    run_one_scan_loop();
+    VERIFY_AND_CLEAR(driver);
+}
+
+TEST_F(ComboIndex, follows_combo_count) {
+    TestDriver driver;
+    KeymapKey  key_x = key_for(KC_X);
+    KeymapKey  key_y = key_for(KC_Y);
+
+    /* The X+Y combo is the last one, drop it */
+    combo_benchmark_count = COMBO_BENCHMARK_COUNT - 1;
+
+    EXPECT_REPORT(driver, (KC_X));
+    EXPECT_REPORT(driver, (KC_X, KC_Y));
+    EXPECT_REPORT(driver, (KC_Y));
+    EXPECT_EMPTY_REPORT(driver);
+    tap_combo({key_x, key_y});
+    VERIFY_AND_CLEAR(driver);
+}
+
+/* Measures the per-event cost of combo processing against the number of
+ * combos. Combo lookups are counted to check that the cost of keys which are
+ * not part of any combo stays flat, and the wall clock time is reported for
+ * information. */
+TEST_F(ComboIndex, benchmark_per_event_cost) {
+    TestDriver driver;
+    KeymapKey  key_z = key_for(KC_Z);
+    KeymapKey  key_a = key_for(KC_A);
+
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(AnyNumber());
+
+    const uint16_t counts[] = {25, 50, 100, 200, COMBO_BENCHMARK_COUNT};
+    const uint16_t taps     = 200;
+    uint32_t       baseline = UINT32_MAX, combo_key_baseline = UINT32_MAX;
+
+    std::cout << std::setw(8) << "combos" << std::setw(16) << "lookups/event" << std::setw(12) << "ns/event" << std::setw(20) << "lookups/combo key" << std::endl;
+    for (uint16_t count : counts) {
+        combo_benchmark_count = count;
+        /* Let the index be rebuilt outside of the measurement */
+        tap_key(key_z);
+
+        combo_benchmark_lookups = 0;
+        auto start              = std::chrono::steady_clock::now();
+        for (uint16_t i = 0; i < taps; i++) {
+            tap_key(key_z);
+        }
+        auto     elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+        uint32_t lookups = combo_benchmark_lookups / (taps * 2);
+
+        combo_benchmark_lookups = 0;
+        tap_key(key_a, COMBO_TERM + 1);
+        uint32_t combo_key_lookups = combo_benchmark_lookups;
+
+        std::cout << std::setw(8) << count << std::setw(16) << lookups << std::setw(12) << elapsed / (taps * 2) << std::setw(20) << combo_key_lookups << std::endl;
+
+        if (baseline == UINT32_MAX) {
+            baseline           = lookups;
+            combo_key_baseline = combo_key_lookups;
+        }
+        /* KC_A is part of the first COMBO_BENCHMARK_KEYS - 1 combos only */
+        EXPECT_EQ(lookups, baseline) << "cost of a non-combo key grows with " << count << " combos";
+        EXPECT_EQ(combo_key_lookups, combo_key_baseline) << "cost of a combo key grows with " << count << " combos";
+    }
+}
@@ -0,0 +1,7 @@
+// Copyright 2024 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+#include "quantum.h"
+
+// Filled in at runtime by the ComboIndex fixture constructor in test_combo_index.cpp
+uint16_t combo_benchmark_keys[COMBO_BENCHMARK_COUNT][3];
+combo_t  key_combos[COMBO_BENCHMARK_COUNT];
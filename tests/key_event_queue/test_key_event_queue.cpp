@@ -0,0 +1,145 @@
+// Copyright 2024 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "keyboard_report_util.hpp"
+#include "keycode.h"
+#include "test_common.hpp"
+#include "test_keymap_key.hpp"
+
+using testing::_;
+using testing::InSequence;
+
+extern "C" {
+#include "key_event_queue.h"
+
+void advance_time(uint32_t ms);
+}
+
+class KeyEventQueue : public TestFixture {
+   protected:
+    static keyevent_t key_event(uint8_t col) {
+        keyevent_t event = {};
+        event.key.col    = col;
+        event.pressed    = true;
+        event.type       = KEY_EVENT;
+        return event;
+    }
+};
+
+TEST_F(KeyEventQueue, PushAndPopInOrder) {
+    keyevent_t event;
+
+    EXPECT_EQ(key_event_queue_count(), 0);
+    EXPECT_FALSE(key_event_queue_pop(&event));
+
+    EXPECT_TRUE(key_event_queue_push(key_event(1)));
+    EXPECT_TRUE(key_event_queue_push(key_event(2)));
+    EXPECT_EQ(key_event_queue_count(), 2);
+
+    EXPECT_TRUE(key_event_queue_pop(&event));
+    EXPECT_EQ(event.key.col, 1);
+    EXPECT_TRUE(key_event_queue_pop(&event));
+    EXPECT_EQ(event.key.col, 2);
+    EXPECT_FALSE(key_event_queue_pop(&event));
+}
+
+TEST_F(KeyEventQueue, CountsOverflows) {
+    keyevent_t event;
+    uint16_t   overflows = key_event_queue_overflows();
+
+    for (uint8_t i = 0; i < KEY_EVENT_QUEUE_SIZE - 1; i++) {
+        EXPECT_TRUE(key_event_queue_push(key_event(i)));
+    }
+    EXPECT_FALSE(key_event_queue_push(key_event(9)));
+    EXPECT_EQ(key_event_queue_overflows(), overflows + 1);
+
+    for (uint8_t i = 0; i < KEY_EVENT_QUEUE_SIZE - 1; i++) {
+        EXPECT_TRUE(key_event_queue_pop(&event));
+        EXPECT_EQ(event.key.col, i);
+    }
+    EXPECT_FALSE(key_event_queue_pop(&event));
+}
+
+TEST_F(KeyEventQueue, KeyPress) {
+    TestDriver driver;
+    auto       key = KeymapKey(0, 0, 0, KC_A);
+
+    set_keymap({key});
+
+    EXPECT_REPORT(driver, (KC_A));
+    key.press();
+    run_one_scan_loop();
+    VERIFY_AND_CLEAR(driver);
+
+    EXPECT_EMPTY_REPORT(driver);
+    key.release();
+    run_one_scan_loop();
+    VERIFY_AND_CLEAR(driver);
+}
+
+TEST_F(KeyEventQueue, ChangesBeyondCapacityAreRetried) {
+    TestDriver driver;
+    InSequence s;
+    auto       key_a = KeymapKey(0, 0, 0, KC_A);
+    auto       key_b = KeymapKey(0, 1, 0, KC_B);
+    auto       key_c = KeymapKey(0, 2, 0, KC_C);
+    auto       key_d = KeymapKey(0, 3, 0, KC_D);
+    auto       key_e = KeymapKey(0, 4, 0, KC_E);
+    uint16_t   overflows = key_event_queue_overflows();
+
+    set_keymap({key_a, key_b, key_c, key_d, key_e});
+
+    EXPECT_REPORT(driver, (KC_A));
+    EXPECT_REPORT(driver, (KC_A, KC_B));
+    EXPECT_REPORT(driver, (KC_A, KC_B, KC_C));
+    key_a.press();
+    key_b.press();
+    key_c.press();
+    key_d.press();
+    key_e.press();
+    run_one_scan_loop();
+    VERIFY_AND_CLEAR(driver);
+    EXPECT_GT(key_event_queue_overflows(), overflows);
+
+    EXPECT_REPORT(driver, (KC_A, KC_B, KC_C, KC_D));
+    EXPECT_REPORT(driver, (KC_A, KC_B, KC_C, KC_D, KC_E));
+    run_one_scan_loop();
+    VERIFY_AND_CLEAR(driver);
+
+    EXPECT_REPORT(driver, (KC_B, KC_C, KC_D, KC_E));
+    EXPECT_REPORT(driver, (KC_C, KC_D, KC_E));
+    EXPECT_REPORT(driver, (KC_D, KC_E));
+    EXPECT_REPORT(driver, (KC_E));
+    EXPECT_EMPTY_REPORT(driver);
+    key_a.release();
+    key_b.release();
+    key_c.release();
+    key_d.release();
+    key_e.release();
+    run_one_scan_loop();
+    run_one_scan_loop();
+    VERIFY_AND_CLEAR(driver);
+}
+
+TEST_F(KeyEventQueue, EventsKeepScanTimestamp) {
+    TestDriver driver;
+    InSequence s;
+    auto       mod_tap_key = KeymapKey(0, 0, 0, SFT_T(KC_P));
+
+    set_keymap({mod_tap_key});
+
+    /* Quick tap, scanned as it happened, but only processed after the tapping term */
+    EXPECT_NO_REPORT(driver);
+    mod_tap_key.press();
+    key_event_queue_scan();
+    advance_time(TAPPING_TERM / 2);
+    mod_tap_key.release();
+    key_event_queue_scan();
+    advance_time(TAPPING_TERM);
+    VERIFY_AND_CLEAR(driver);
+
+    EXPECT_REPORT(driver, (KC_P));
+    EXPECT_EMPTY_REPORT(driver);
+    run_one_scan_loop();
+    VERIFY_AND_CLEAR(driver);
+}
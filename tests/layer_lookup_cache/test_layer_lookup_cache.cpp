@@ -0,0 +1,140 @@
+// Copyright 2024 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "keyboard_report_util.hpp"
+#include "keycode.h"
+#include "test_common.hpp"
+#include "test_keymap_key.hpp"
+
+using testing::_;
+using testing::InSequence;
+
+class LayerLookupCache : public TestFixture {
+   protected:
+    /* Maps every position not explicitly given: KC_NO on layer 0, KC_TRNS above. */
+    void set_full_keymap(std::initializer_list<KeymapKey> keys, layer_t layers) {
+        set_keymap(keys);
+        for (layer_t layer = 0; layer < layers; layer++) {
+            for (uint8_t row = 0; row < MATRIX_ROWS; row++) {
+                for (uint8_t col = 0; col < MATRIX_COLS; col++) {
+                    if (!find_key(layer, keypos_t{.col = col, .row = row})) {
+                        add_key(KeymapKey{layer, col, row, layer == 0 ? KC_NO : KC_TRNS});
+                    }
+                }
+            }
+        }
+    }
+};
+
+TEST_F(LayerLookupCache, ResolvesThroughTransparentLayers) {
+    set_full_keymap({KeymapKey{0, 1, 0, KC_A}, KeymapKey{1, 2, 0, KC_B}, KeymapKey{2, 1, 0, KC_C}}, 3);
+
+    EXPECT_EQ(layer_switch_get_layer(keypos_t{.col = 1, .row = 0}), 0);
+    EXPECT_EQ(layer_switch_get_layer(keypos_t{.col = 2, .row = 0}), 0);
+
+    layer_on(1);
+    EXPECT_EQ(layer_switch_get_layer(keypos_t{.col = 1, .row = 0}), 0);
+    EXPECT_EQ(layer_switch_get_layer(keypos_t{.col = 2, .row = 0}), 1);
+
+    layer_on(2);
+    EXPECT_EQ(layer_switch_get_layer(keypos_t{.col = 1, .row = 0}), 2);
+    EXPECT_EQ(layer_switch_get_layer(keypos_t{.col = 2, .row = 0}), 1);
+
+    /* Removing a layer below the resolved one has no effect */
+    layer_off(1);
+    EXPECT_EQ(layer_switch_get_layer(keypos_t{.col = 1, .row = 0}), 2);
+    EXPECT_EQ(layer_switch_get_layer(keypos_t{.col = 2, .row = 0}), 0);
+
+    layer_off(2);
+    EXPECT_EQ(layer_switch_get_layer(keypos_t{.col = 1, .row = 0}), 0);
+    EXPECT_EQ(layer_switch_get_layer(keypos_t{.col = 2, .row = 0}), 0);
+}
+
+TEST_F(LayerLookupCache, FallsBackToLowerLayerOnRemoval) {
+    set_full_keymap({KeymapKey{0, 1, 0, KC_A}, KeymapKey{1, 1, 0, KC_B}, KeymapKey{3, 1, 0, KC_C}}, 4);
+
+    layer_on(1);
+    layer_on(2);
+    layer_on(3);
+    EXPECT_EQ(layer_switch_get_layer(keypos_t{.col = 1, .row = 0}), 3);
+
+    /* Layer 2 is still on but transparent, so layer 1 takes over */
+    layer_off(3);
+    EXPECT_EQ(layer_switch_get_layer(keypos_t{.col = 1, .row = 0}), 1);
+
+    layer_move(2);
+    EXPECT_EQ(layer_switch_get_layer(keypos_t{.col = 1, .row = 0}), 0);
+}
+
+TEST_F(LayerLookupCache, FollowsDefaultLayer) {
+    set_full_keymap({KeymapKey{1, 1, 0, KC_B}}, 2);
+
+    default_layer_set(1UL << 1);
+    EXPECT_EQ(layer_switch_get_layer(keypos_t{.col = 1, .row = 0}), 1);
+    /* Transparent everywhere, falls back to layer 0 */
+    EXPECT_EQ(layer_switch_get_layer(keypos_t{.col = 2, .row = 0}), 0);
+
+    default_layer_set(1UL << 0);
+    EXPECT_EQ(layer_switch_get_layer(keypos_t{.col = 1, .row = 0}), 0);
+}
+
+TEST_F(LayerLookupCache, InvalidatedByKeymapChange) {
+    set_full_keymap({}, 2);
+
+    layer_on(1);
+    EXPECT_EQ(layer_switch_get_layer(keypos_t{.col = 1, .row = 0}), 0);
+
+    set_full_keymap({KeymapKey{1, 1, 0, KC_B}}, 2);
+    EXPECT_EQ(layer_switch_get_layer(keypos_t{.col = 1, .row = 0}), 1);
+}
+
+TEST_F(LayerLookupCache, MomentaryLayerWithKeypress) {
+    TestDriver driver;
+    InSequence s;
+    KeymapKey  layer_key   = KeymapKey{0, 0, 0, MO(1)};
+    KeymapKey  regular_key = KeymapKey{0, 1, 0, KC_A};
+    KeymapKey  layer_1_key = KeymapKey{1, 1, 0, KC_B};
+
+    set_full_keymap({layer_key, regular_key, layer_1_key}, 2);
+
+    EXPECT_REPORT(driver, (KC_A));
+    regular_key.press();
+    run_one_scan_loop();
+    VERIFY_AND_CLEAR(driver);
+
+    EXPECT_EMPTY_REPORT(driver);
+    regular_key.release();
+    run_one_scan_loop();
+    VERIFY_AND_CLEAR(driver);
+
+    EXPECT_NO_REPORT(driver);
+    layer_key.press();
+    run_one_scan_loop();
+    VERIFY_AND_CLEAR(driver);
+
+    EXPECT_REPORT(driver, (KC_B));
+    regular_key.press();
+    run_one_scan_loop();
+    VERIFY_AND_CLEAR(driver);
+
+    /* Releasing the layer key keeps the source layer for the held key */
+    EXPECT_NO_REPORT(driver);
+    layer_key.release();
+    run_one_scan_loop();
+    VERIFY_AND_CLEAR(driver);
+
+    EXPECT_EMPTY_REPORT(driver);
+    regular_key.release();
+    run_one_scan_loop();
+    VERIFY_AND_CLEAR(driver);
+
+    EXPECT_REPORT(driver, (KC_A));
+    regular_key.press();
+    run_one_scan_loop();
+    VERIFY_AND_CLEAR(driver);
+
+    EXPECT_EMPTY_REPORT(driver);
+    regular_key.release();
+    run_one_scan_loop();
+    VERIFY_AND_CLEAR(driver);
+}
@@ -0,0 +1,198 @@
+// Copyright 2024 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <vector>
+#include "keycode.h"
+#include "test_common.hpp"
+#include "test_fixture.hpp"
+#include "test_keymap_key.hpp"
+
+extern "C" {
+#include "kinematics.h"
+}
+
+using testing::_;
+using testing::AnyNumber;
+using testing::Invoke;
+
+TEST(Kinematics, MovesInFractionsOfAUnit) {
+    kinematics_axis_t axis  = {kinematics_rate(-3, 10), 0};
+    int16_t           total = 0;
+
+    for (uint8_t i = 0; i < 10; i++) {
+        int16_t units = kinematics_move(&axis, 1);
+        EXPECT_LE(units, 0);
+        EXPECT_GE(units, -1);
+        total += units;
+    }
+    EXPECT_EQ(total, -3);
+}
+
+TEST(Kinematics, BrakesToAStop) {
+    kinematics_axis_t axis  = {kinematics_rate(10, 1), 0};
+    int16_t           total = 0;
+
+    // 10 units per ms, slowing down by 1 unit per ms every ms, stops after 10 ms and 50 units
+    for (uint8_t i = 0; i < 8; i++) {
+        total += kinematics_brake(&axis, Q16_ONE, 2);
+    }
+    EXPECT_EQ(axis.velocity, 0);
+    EXPECT_EQ(total, 50);
+}
+
+TEST(Kinematics, Hypot) {
+    EXPECT_EQ(kinematics_hypot(3, -4), 5);
+    EXPECT_EQ(kinematics_hypot(-INT16_MAX, INT16_MAX), 46339);
+}
+
+class MousekeysCursor : public TestFixture {
+   protected:
+    std::vector<int16_t> cursor;
+
+    void record_cursor(TestDriver &driver) {
+        EXPECT_CALL(driver, send_keyboard_mock(_)).Times(AnyNumber());
+        EXPECT_CALL(driver, send_mouse_mock(_)).WillRepeatedly(Invoke([this](report_mouse_t &report) {
+            if (report.x) {
+                cursor.push_back(report.x);
+            }
+        }));
+    }
+};
+
+TEST_F(MousekeysCursor, HoldAcceleratesEveryInterval) {
+    TestDriver driver;
+    KeymapKey  key = KeymapKey(0, 0, 0, KC_MS_R);
+
+    set_keymap({key});
+    record_cursor(driver);
+
+    key.press();
+    run_one_scan_loop();
+    idle_for(MOUSEKEY_DELAY + MOUSEKEY_INTERVAL * 4);
+    key.release();
+    run_one_scan_loop();
+
+    // The press moves by the delta, then each interval by the accelerating speed
+    std::vector<int16_t> expected;
+    expected.push_back(MOUSEKEY_MOVE_DELTA);
+    for (uint8_t repeat = 1; repeat <= 4; repeat++) {
+        expected.push_back(MOUSEKEY_MOVE_DELTA * MOUSEKEY_MAX_SPEED * repeat / MOUSEKEY_TIME_TO_MAX);
+    }
+    EXPECT_EQ(cursor, expected);
+}
+
+TEST_F(MousekeysCursor, MovesEveryIntervalPlusOneMs) {
+    TestDriver            driver;
+    KeymapKey             key = KeymapKey(0, 0, 0, KC_MS_R);
+    std::vector<uint16_t> times;
+
+    set_keymap({key});
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(AnyNumber());
+    EXPECT_CALL(driver, send_mouse_mock(_)).WillRepeatedly(Invoke([&](report_mouse_t &report) {
+        if (report.x) {
+            times.push_back(timer_read());
+        }
+    }));
+
+    key.press();
+    run_one_scan_loop();
+    idle_for(MOUSEKEY_DELAY + (MOUSEKEY_INTERVAL + 1) * 4);
+    key.release();
+    run_one_scan_loop();
+
+    // With MOUSEKEY_REPORT_INTERVAL left at MOUSEKEY_INTERVAL, repeats keep their original cadence
+    ASSERT_EQ(times.size(), 5);
+    for (size_t i = 2; i < times.size(); i++) {
+        EXPECT_EQ(times[i] - times[i - 1], MOUSEKEY_INTERVAL + 1);
+    }
+}
+
+class MousekeysHiresScroll : public TestFixture {
+   protected:
+    std::vector<int16_t> wheel;
+
+    // As after the host sets the Resolution Multiplier of both wheels to its logical maximum of 1
+    MousekeysHiresScroll() {
+        host_mouse_resolution_multiplier_set(0x05);
+    }
+
+    ~MousekeysHiresScroll() {
+        host_mouse_resolution_multiplier_set(0);
+    }
+
+    void record_wheel(TestDriver &driver) {
+        EXPECT_CALL(driver, send_keyboard_mock(_)).Times(AnyNumber());
+        EXPECT_CALL(driver, send_mouse_mock(_)).WillRepeatedly(Invoke([this](report_mouse_t &report) {
+            if (report.v) {
+                wheel.push_back(report.v);
+            }
+        }));
+    }
+};
+
+TEST_F(MousekeysHiresScroll, PressScrollsOneDetent) {
+    TestDriver driver;
+    KeymapKey  key = KeymapKey(0, 0, 0, KC_WH_U);
+
+    set_keymap({key});
+    record_wheel(driver);
+
+    tap_key(key);
+
+    ASSERT_EQ(wheel.size(), 1);
+    EXPECT_EQ(wheel[0], MOUSE_HIRES_SCROLL_MULTIPLIER);
+}
+
+TEST_F(MousekeysHiresScroll, ScrollsWholeDetentsUntilTheHostEnablesIt) {
+    TestDriver driver;
+    KeymapKey  key_v = KeymapKey(0, 0, 0, KC_WH_U);
+    KeymapKey  key_h = KeymapKey(0, 1, 0, KC_WH_R);
+
+    set_keymap({key_v, key_h});
+    std::vector<int16_t> pan;
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(AnyNumber());
+    EXPECT_CALL(driver, send_mouse_mock(_)).WillRepeatedly(Invoke([&](report_mouse_t &report) {
+        if (report.v) {
+            wheel.push_back(report.v);
+        }
+        if (report.h) {
+            pan.push_back(report.h);
+        }
+    }));
+
+    host_mouse_resolution_multiplier_set(0);
+    tap_key(key_v);
+    // Only the vertical wheel
+    host_mouse_resolution_multiplier_set(0x01);
+    tap_key(key_v);
+    tap_key(key_h);
+
+    EXPECT_EQ(wheel, std::vector<int16_t>({1, MOUSE_HIRES_SCROLL_MULTIPLIER}));
+    EXPECT_EQ(pan, std::vector<int16_t>({1}));
+}
+
+TEST_F(MousekeysHiresScroll, HoldScrollsInFractionsOfADetent) {
+    TestDriver driver;
+    KeymapKey  key = KeymapKey(0, 0, 0, KC_WH_D);
+
+    set_keymap({key});
+    record_wheel(driver);
+
+    key.press();
+    run_one_scan_loop();
+    idle_for(MOUSEKEY_WHEEL_INTERVAL * 10);
+    key.release();
+    run_one_scan_loop();
+
+    // One detent on press, then about one every wheel interval (two once accelerated), in smaller steps
+    ASSERT_GT(wheel.size(), 20);
+    EXPECT_EQ(wheel[0], -MOUSE_HIRES_SCROLL_MULTIPLIER);
+    int32_t total = 0;
+    for (size_t i = 1; i < wheel.size(); i++) {
+        EXPECT_LT(wheel[i], 0);
+        EXPECT_GT(wheel[i], -MOUSE_HIRES_SCROLL_MULTIPLIER);
+        total -= wheel[i];
+    }
+    EXPECT_GE(total, 9 * MOUSE_HIRES_SCROLL_MULTIPLIER);
+    EXPECT_LE(total, 11 * MOUSE_HIRES_SCROLL_MULTIPLIER);
+}
@@ -0,0 +1,106 @@
+// Copyright 2024 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+// Hashes of the frames rendered by each effect in test_rgb_matrix_effects.cpp
+
+#if RGB_MATRIX_LED_COUNT == 100
+    {"SOLID_COLOR", 0x7a5558c5},
+    {"ALPHAS_MODS", 0xc09d05c5},
+    {"GRADIENT_UP_DOWN", 0xce77e2c5},
+    {"GRADIENT_LEFT_RIGHT", 0x5c5897c5},
+    {"BREATHING", 0x622341a5},
+    {"BAND_SAT", 0xa16cd857},
+    {"BAND_VAL", 0xfce5426e},
+    {"BAND_PINWHEEL_SAT", 0x27824c09},
+    {"BAND_PINWHEEL_VAL", 0x4d694849},
+    {"BAND_SPIRAL_SAT", 0x9c644734},
+    {"BAND_SPIRAL_VAL", 0xe34f4b6b},
+    {"CYCLE_ALL", 0x453abca5},
+    {"CYCLE_LEFT_RIGHT", 0xdfb36d4b},
+    {"CYCLE_UP_DOWN", 0xc6138d9d},
+    {"RAINBOW_MOVING_CHEVRON", 0x4592073b},
+    {"CYCLE_OUT_IN", 0xe6ad144f},
+    {"CYCLE_OUT_IN_DUAL", 0xb23e2af},
+    {"CYCLE_PINWHEEL", 0x69e715a1},
+    {"CYCLE_SPIRAL", 0x27601ce3},
+    {"DUAL_BEACON", 0x99899b7f},
+    {"RAINBOW_BEACON", 0xe66b8b6b},
+    {"RAINBOW_PINWHEELS", 0x495a8a1b},
+    {"FLOWER_BLOOMING", 0x594ba3ab},
+    {"RAINDROPS", 0x85146f73},
+    {"JELLYBEAN_RAINDROPS", 0x197c6e7e},
+    {"HUE_BREATHING", 0xca746485},
+    {"HUE_PENDULUM", 0x85e2409b},
+    {"HUE_WAVE", 0xdfccbcfb},
+    {"PIXEL_RAIN", 0x8d1c507d},
+    {"PIXEL_FLOW", 0xcb396255},
+    {"PIXEL_FRACTAL", 0xfecc1a85},
+    {"TYPING_HEATMAP", 0xe197c1f5},
+    {"DIGITAL_RAIN", 0xc7239d6f},
+    {"SOLID_REACTIVE_SIMPLE", 0xa35c3085},
+    {"SOLID_REACTIVE", 0x303f2b05},
+    {"SOLID_REACTIVE_WIDE", 0x5d3efb75},
+    {"SOLID_REACTIVE_MULTIWIDE", 0x4cfc54d7},
+    {"SOLID_REACTIVE_CROSS", 0xd7657079},
+    {"SOLID_REACTIVE_MULTICROSS", 0x551d7739},
+    {"SOLID_REACTIVE_NEXUS", 0xc896898b},
+    {"SOLID_REACTIVE_MULTINEXUS", 0x43921684},
+    {"SPLASH", 0xd708ec55},
+    {"MULTISPLASH", 0x89f2900d},
+    {"SOLID_SPLASH", 0x2f343f01},
+    {"SOLID_MULTISPLASH", 0x92549e04},
+    {"STARLIGHT", 0xe9635267},
+    {"STARLIGHT_DUAL_SAT", 0xdb2a44c2},
+    {"STARLIGHT_DUAL_HUE", 0x5499c881},
+    {"RIVERFLOW", 0x514fcc52},
+#elif RGB_MATRIX_LED_COUNT == 200
+    {"SOLID_COLOR", 0xcb5213c5},
+    {"ALPHAS_MODS", 0xf0b88cc5},
+    {"GRADIENT_UP_DOWN", 0xd7ffddc5},
+    {"GRADIENT_LEFT_RIGHT", 0x594c91c5},
+    {"BREATHING", 0x125988b5},
+    {"BAND_SAT", 0x51754c2d},
+    {"BAND_VAL", 0x856dc3ed},
+    {"BAND_PINWHEEL_SAT", 0x805acf14},
+    {"BAND_PINWHEEL_VAL", 0x4843e3f5},
+    {"BAND_SPIRAL_SAT", 0xa24fa1ed},
+    {"BAND_SPIRAL_VAL", 0x6cd3abe9},
+    {"CYCLE_ALL", 0x96e08cc5},
+    {"CYCLE_LEFT_RIGHT", 0x8214ce79},
+    {"CYCLE_UP_DOWN", 0x8d07cb65},
+    {"RAINBOW_MOVING_CHEVRON", 0x650ec1dd},
+    {"CYCLE_OUT_IN", 0x405073db},
+    {"CYCLE_OUT_IN_DUAL", 0x9990aeb5},
+    {"CYCLE_PINWHEEL", 0x8b53830f},
+    {"CYCLE_SPIRAL", 0x8f851449},
+    {"DUAL_BEACON", 0xd3565a0b},
+    {"RAINBOW_BEACON", 0x9168431f},
+    {"RAINBOW_PINWHEELS", 0x8c003c27},
+    {"FLOWER_BLOOMING", 0x493e16bf},
+    {"RAINDROPS", 0xe33a767},
+    {"JELLYBEAN_RAINDROPS", 0x3a777c2e},
+    {"HUE_BREATHING", 0xbf6ec3a5},
+    {"HUE_PENDULUM", 0x4dc4f505},
+    {"HUE_WAVE", 0xb82a065d},
+    {"PIXEL_RAIN", 0xd1c36e8d},
+    {"PIXEL_FLOW", 0x7a20c955},
+    {"PIXEL_FRACTAL", 0x5320b8b5},
+    {"TYPING_HEATMAP", 0xd35c33be},
+    {"DIGITAL_RAIN", 0x6844d793},
+    {"SOLID_REACTIVE_SIMPLE", 0x5eee978f},
+    {"SOLID_REACTIVE", 0x126b8689},
+    {"SOLID_REACTIVE_WIDE", 0x16ac1c61},
+    {"SOLID_REACTIVE_MULTIWIDE", 0xa0d67529},
+    {"SOLID_REACTIVE_CROSS", 0x31f03606},
+    {"SOLID_REACTIVE_MULTICROSS", 0xb1fde401},
+    {"SOLID_REACTIVE_NEXUS", 0xfd689cce},
+    {"SOLID_REACTIVE_MULTINEXUS", 0x133af0b5},
+    {"SPLASH", 0x9853f3b2},
+    {"MULTISPLASH", 0xf92ddd0d},
+    {"SOLID_SPLASH", 0x9218655c},
+    {"SOLID_MULTISPLASH", 0x83cec100},
+    {"STARLIGHT", 0x183a1637},
+    {"STARLIGHT_DUAL_SAT", 0xf2b48efe},
+    {"STARLIGHT_DUAL_HUE", 0xb906ca3},
+    {"RIVERFLOW", 0xa138aa3f},
+#endif
@@ -0,0 +1,12 @@
+// Copyright 2024 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+// Same layout as rgb_matrix_200_leds, so the frames must match its golden ones
+#define RGB_MATRIX_LED_COUNT 200
+
+#define RGB_MATRIX_HSV_TO_RGB_BATCH
+#define RGB_MATRIX_LED_POLAR_CACHE
+
+#include "../config.h"
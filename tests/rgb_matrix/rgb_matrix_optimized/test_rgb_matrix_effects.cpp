@@ -0,0 +1,5 @@
+// Copyright 2024 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+// Built here rather than added to SRC, as its object depends on this config.h
+#include "../test_rgb_matrix_effects.cpp"
@@ -0,0 +1,254 @@
+// Copyright 2024 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include "test_common.hpp"
+
+extern "C" {
+#include "rgb_matrix.h"
+#ifdef RGB_MATRIX_RENDER_BUDGET_US
+#    include "render_budget.h"
+#endif
+
+extern uint16_t rand16seed;
+
+void advance_time(uint32_t ms);
+}
+
+/* Effects are rendered for a fixed number of frames, with a key hit every few
+ * of them for the reactive effects, and every frame sent to the mock driver is
+ * hashed. The hashes of each layout are compared against the golden ones, which
+ * were taken from the plain implementations of the effects, so that changes
+ * made to speed them up can be checked to render exactly the same frames. */
+#define TEST_FRAMES 64
+#define TEST_HIT_INTERVAL 12
+#define TEST_LED_COLS 20
+#define TEST_LED_ROWS (RGB_MATRIX_LED_COUNT / TEST_LED_COLS)
+
+static RGB      frame[RGB_MATRIX_LED_COUNT];
+static uint16_t flushes;
+static uint32_t frame_hash;
+
+#ifdef RGB_MATRIX_RENDER_BUDGET_US
+/* The render budget is measured with a mock cycle counter, which only moves
+ * forward by a set cost for every LED that is rendered, so that slicing does
+ * not depend on how fast the host is. */
+static uint32_t mock_cycles;
+static uint32_t mock_led_cost;
+
+extern "C" uint32_t cycle_counter_read(void) {
+    return mock_cycles;
+}
+
+extern "C" uint32_t cycle_counter_from_us(uint32_t us) {
+    return us * 100;
+}
+#endif
+
+static void mock_init(void) {}
+
+static void mock_set_color(int index, uint8_t r, uint8_t g, uint8_t b) {
+#ifdef RGB_MATRIX_RENDER_BUDGET_US
+    mock_cycles += mock_led_cost;
+#endif
+    if (index >= 0 && index < RGB_MATRIX_LED_COUNT) {
+        frame[index] = (RGB){r, g, b};
+    }
+}
+
+static void mock_set_color_all(uint8_t r, uint8_t g, uint8_t b) {
+    for (int i = 0; i < RGB_MATRIX_LED_COUNT; i++) {
+        mock_set_color(i, r, g, b);
+    }
+}
+
+/* FNV-1a over every frame flushed since the hash was last reset */
+static void mock_flush(void) {
+    for (int i = 0; i < RGB_MATRIX_LED_COUNT; i++) {
+        for (uint8_t channel : {frame[i].r, frame[i].g, frame[i].b}) {
+            frame_hash = (frame_hash ^ channel) * 16777619UL;
+        }
+    }
+    flushes++;
+}
+
+extern "C" const rgb_matrix_driver_t rgb_matrix_driver = {
+    .init          = mock_init,
+    .set_color     = mock_set_color,
+    .set_color_all = mock_set_color_all,
+    .flush         = mock_flush,
+};
+
+/* LEDs laid out in a grid spanning the whole 224x64 area, with the keys spread
+ * over it, modifiers among them, and underglow LEDs in between. */
+static led_config_t make_led_config(void) {
+    led_config_t config = {};
+
+    for (uint8_t i = 0; i < RGB_MATRIX_LED_COUNT; i++) {
+        config.point[i] = (led_point_t){(uint8_t)(i % TEST_LED_COLS * 224 / (TEST_LED_COLS - 1)), (uint8_t)(i / TEST_LED_COLS * 64 / (TEST_LED_ROWS - 1))};
+        config.flags[i] = LED_FLAG_UNDERGLOW;
+    }
+    for (uint8_t row = 0; row < MATRIX_ROWS; row++) {
+        for (uint8_t col = 0; col < MATRIX_COLS; col++) {
+            uint8_t key = row * MATRIX_COLS + col;
+            uint8_t led = key * RGB_MATRIX_LED_COUNT / (MATRIX_ROWS * MATRIX_COLS);
+
+            config.matrix_co[row][col] = led;
+            config.flags[led]          = key % 4 ? LED_FLAG_KEYLIGHT : LED_FLAG_MODIFIER;
+        }
+    }
+    return config;
+}
+
+extern "C" led_config_t g_led_config = make_led_config();
+
+typedef struct {
+    uint8_t     mode;
+    const char *name;
+} effect_t;
+
+typedef struct {
+    const char *name;
+    uint32_t    hash;
+} golden_frames_t;
+
+static const effect_t effects[] = {
+#define RGB_MATRIX_EFFECT(name, ...) {RGB_MATRIX_##name, #name},
+#include "rgb_matrix_effects.inc"
+#undef RGB_MATRIX_EFFECT
+};
+
+static const golden_frames_t golden_frames[] = {
+#include "rgb_matrix_golden_frames.h"
+};
+
+#ifdef RGB_MATRIX_RENDER_BUDGET_US
+/* These change LEDs once per slice rather than once per frame, so their frames
+ * depend on how the LEDs are sliced, which then depends on the render budget. */
+static const char *const slice_dependent_effects[] = {"RAINDROPS", "JELLYBEAN_RAINDROPS", "PIXEL_FLOW"};
+#endif
+
+static bool is_slice_dependent(const char *name) {
+#ifdef RGB_MATRIX_RENDER_BUDGET_US
+    for (const char *effect : slice_dependent_effects) {
+        if (strcmp(effect, name) == 0) {
+            return true;
+        }
+    }
+#endif
+    return false;
+}
+
+static const golden_frames_t *find_golden_frames(const char *name) {
+    for (const golden_frames_t &golden : golden_frames) {
+        if (strcmp(golden.name, name) == 0) {
+            return &golden;
+        }
+    }
+    return nullptr;
+}
+
+/* Runs the task until the next frame is flushed, and returns how many runs it took */
+static uint8_t render_frame(void) {
+    uint16_t flushed = flushes;
+    uint8_t  tasks   = 0;
+
+    while (flushes == flushed && tasks < UINT8_MAX) {
+        rgb_matrix_task();
+        tasks++;
+    }
+    return tasks;
+}
+
+class RgbMatrixEffects : public TestFixture {};
+
+TEST_F(RgbMatrixEffects, MatchGoldenFrames) {
+    uint8_t hit = 0;
+
+    std::cout << "rgb_matrix, " << RGB_MATRIX_LED_COUNT << " LEDs:" << std::endl;
+    for (const effect_t &effect : effects) {
+        SCOPED_TRACE(effect.name);
+
+        rgb_matrix_mode_noeeprom(effect.mode);
+        rand16seed = 1337;
+        srand(1337);
+        frame_hash = 2166136261UL;
+
+        auto elapsed = std::chrono::nanoseconds::zero();
+        for (uint16_t i = 0; i < TEST_FRAMES; i++) {
+            if (i % TEST_HIT_INTERVAL == 0) {
+                rgb_matrix_handle_key_event(hit / MATRIX_COLS, hit % MATRIX_COLS, true);
+                hit = (hit + 7) % (MATRIX_ROWS * MATRIX_COLS);
+            }
+            advance_time(RGB_MATRIX_LED_FLUSH_LIMIT);
+
+            uint16_t flushed = flushes;
+            auto     start   = std::chrono::steady_clock::now();
+            render_frame();
+            elapsed += std::chrono::steady_clock::now() - start;
+            ASSERT_NE(flushes, flushed) << "no frame flushed";
+        }
+
+        std::cout << std::setw(28) << effect.name << std::setw(10) << elapsed.count() / TEST_FRAMES << " ns/frame" << std::endl;
+
+        if (is_slice_dependent(effect.name)) {
+            continue;
+        }
+        const golden_frames_t *golden = find_golden_frames(effect.name);
+        if (golden) {
+            EXPECT_EQ(frame_hash, golden->hash);
+        } else {
+            ADD_FAILURE() << "no golden frames, add:" << std::endl << std::hex << "    {\"" << effect.name << "\", 0x" << frame_hash << "},";
+        }
+    }
+}
+
+#ifdef RGB_MATRIX_RENDER_BUDGET_US
+/* Renders a few frames of an effect costing led_cost per LED, and returns how
+ * many task runs the last one took, once the cost has been measured. */
+static uint8_t render_with_cost(uint8_t mode, uint32_t led_cost) {
+    uint8_t tasks = 0;
+
+    rgb_matrix_mode_noeeprom(mode);
+    mock_led_cost = led_cost;
+    for (uint8_t i = 0; i < 8; i++) {
+        advance_time(RGB_MATRIX_LED_FLUSH_LIMIT);
+        tasks = render_frame();
+    }
+    mock_led_cost = 0;
+    return tasks;
+}
+
+/* Cheap effects should fit more LEDs in each slice than expensive ones, and so
+ * take fewer task runs to render a frame. */
+TEST_F(RgbMatrixEffects, SlicesFollowEffectCost) {
+    // The whole frame fits in one slice, or takes a slice per LED
+    uint32_t budget    = cycle_counter_from_us(RGB_MATRIX_RENDER_BUDGET_US);
+    uint8_t  cheap     = render_with_cost(RGB_MATRIX_SOLID_COLOR, 1);
+    uint8_t  expensive = render_with_cost(RGB_MATRIX_SOLID_COLOR, budget);
+
+    EXPECT_LT(cheap, expensive);
+    EXPECT_EQ(expensive - cheap, RGB_MATRIX_LED_COUNT - 1);
+
+    // And the budget is measured again when the effect changes
+    EXPECT_EQ(render_with_cost(RGB_MATRIX_BREATHING, budget / 4), cheap + CEILING(RGB_MATRIX_LED_COUNT, 4) - 1);
+}
+
+/* On a coarse counter an LED can cost much less than one unit, which must
+ * still let more LEDs into each slice than an LED costing one unit would. */
+TEST_F(RgbMatrixEffects, SlicesFollowSubUnitCost) {
+    render_budget_t render_budget;
+
+    // 100 units, and slices of 100 LEDs taking 50 units, so 200 LEDs fit
+    render_budget_init(&render_budget, 1);
+    for (uint8_t i = 0; i < 16; i++) {
+        render_budget_begin(&render_budget);
+        mock_cycles += 50;
+        render_budget_end(&render_budget, 100);
+    }
+    EXPECT_EQ(render_budget_slice(&render_budget, 0), 200);
+}
+#endif
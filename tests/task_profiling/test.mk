@@ -0,0 +1,6 @@
+# Copyright 2024 QMK
+# SPDX-License-Identifier: GPL-2.0-or-later
+
+TASK_PROFILING_ENABLE = yes
+
+CAPS_WORD_ENABLE = yes
@@ -0,0 +1,85 @@
+// Copyright 2024 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "keyboard_report_util.hpp"
+#include "keycode.h"
+#include "test_common.hpp"
+#include "test_fixture.hpp"
+#include "test_keymap_key.hpp"
+#include "task_profiling.h"
+
+using testing::_;
+
+class TaskProfiling : public TestFixture {
+   public:
+    void SetUp() override {
+        task_profiling_reset();
+    }
+};
+
+TEST_F(TaskProfiling, ScanLoopPopulatesSlots) {
+    TestDriver driver;
+    EXPECT_NO_REPORT(driver);
+
+    idle_for(10);
+
+    for (uint8_t slot : {TASK_PROFILE_ID_KEYBOARD_TASK, TASK_PROFILE_ID_MATRIX_TASK, TASK_PROFILE_ID_QUANTUM_TASK, TASK_PROFILE_ID_CAPS_WORD_TASK, TASK_PROFILE_ID_LED_TASK, TASK_PROFILE_ID_HOUSEKEEPING_TASK}) {
+        const task_profiling_stats_t *stats = task_profiling_get_stats(slot);
+        ASSERT_NE(stats, nullptr);
+        EXPECT_EQ(stats->count, 10) << task_profiling_get_name(slot);
+        EXPECT_LE(stats->min, stats->max);
+    }
+
+    // The whole loop can never be cheaper than one of its stages
+    EXPECT_GE(task_profiling_get_stats(TASK_PROFILE_ID_KEYBOARD_TASK)->max, task_profiling_get_stats(TASK_PROFILE_ID_MATRIX_TASK)->min);
+    VERIFY_AND_CLEAR(driver);
+}
+
+TEST_F(TaskProfiling, MinMaxAndPercentiles) {
+    for (int i = 0; i < 99; i++) {
+        task_profiling_record(TASK_PROFILE_ID_MATRIX_TASK, 100);
+    }
+    task_profiling_record(TASK_PROFILE_ID_MATRIX_TASK, 5000);
+
+    const task_profiling_stats_t *stats = task_profiling_get_stats(TASK_PROFILE_ID_MATRIX_TASK);
+    EXPECT_EQ(stats->count, 100);
+    EXPECT_EQ(stats->min, 100);
+    EXPECT_EQ(stats->max, 5000);
+    EXPECT_EQ(stats->last, 5000);
+
+    // 100 lands in the [64, 128) bucket, 5000 in the [4096, 8192) bucket
+    EXPECT_EQ(task_profiling_get_percentile(TASK_PROFILE_ID_MATRIX_TASK, 50), 127);
+    EXPECT_EQ(task_profiling_get_percentile(TASK_PROFILE_ID_MATRIX_TASK, 99), 127);
+    EXPECT_EQ(task_profiling_get_percentile(TASK_PROFILE_ID_MATRIX_TASK, 100), 5000);
+}
+
+TEST_F(TaskProfiling, OutOfRangeSlotIsIgnored) {
+    task_profiling_record(TASK_PROFILE_ID_COUNT, 1234);
+    EXPECT_EQ(task_profiling_get_stats(TASK_PROFILE_ID_COUNT), nullptr);
+    EXPECT_EQ(task_profiling_get_percentile(TASK_PROFILE_ID_COUNT, 99), 0);
+}
+
+TEST_F(TaskProfiling, RawHidQueries) {
+    uint8_t data[32] = {TASK_PROFILING_RAW_HID_COMMAND_ID, TASK_PROFILING_RAW_HID_GET_SLOT_COUNT};
+    EXPECT_TRUE(task_profiling_raw_hid_receive(data, sizeof(data)));
+    EXPECT_EQ(data[3], TASK_PROFILE_ID_COUNT);
+
+    task_profiling_record(TASK_PROFILE_ID_LED_TASK, 0x01020304);
+    memset(data, 0, sizeof(data));
+    data[0] = TASK_PROFILING_RAW_HID_COMMAND_ID;
+    data[1] = TASK_PROFILING_RAW_HID_GET_SLOT_STATS;
+    data[2] = TASK_PROFILE_ID_LED_TASK;
+    EXPECT_TRUE(task_profiling_raw_hid_receive(data, sizeof(data)));
+    EXPECT_EQ(data[1], TASK_PROFILING_RAW_HID_GET_SLOT_STATS);
+    EXPECT_EQ(data[3], 1); // count
+    EXPECT_EQ(data[7], 0x04); // min, little-endian
+    EXPECT_EQ(data[10], 0x01);
+
+    data[1] = TASK_PROFILING_RAW_HID_GET_SLOT_STATS;
+    data[2] = TASK_PROFILE_ID_COUNT;
+    EXPECT_TRUE(task_profiling_raw_hid_receive(data, sizeof(data)));
+    EXPECT_EQ(data[1], 0xFF);
+
+    data[0] = 0x01;
+    EXPECT_FALSE(task_profiling_raw_hid_receive(data, sizeof(data)));
+}
@@ -28,6 +28,7 @@ void advance_time(uint32_t ms);
 }
 
 using testing::_;
+using testing::AnyNumber;
 
 /* This is used for dynamic dispatching keymap_key_to_keycode calls to the current active test_fixture. */
 TestFixture* TestFixture::m_this = nullptr;
@@ -65,6 +66,10 @@ TestFixture::TestFixture() {
 TestFixture::~TestFixture() {
     test_logger.info() << "test fixture clean-up start." << std::endl;
     TestDriver driver;
+#if defined(MOUSEKEY_ENABLE)
+    // clear_keyboard() always sends an empty mouse report
+    EXPECT_CALL(driver, send_mouse_mock(_)).Times(AnyNumber());
+#endif
 
     /* Reset keyboard state. */
     clear_all_keys();
@@ -100,6 +105,7 @@ void TestFixture::add_key(KeymapKey key) {
     }
 
     this->keymap.push_back(key);
+    layer_lookup_cache_invalidate();
 }
 
 void TestFixture::tap_key(KeymapKey key, unsigned delay_ms) {
@@ -127,6 +133,7 @@ void TestFixture::tap_combo(const std::vector<KeymapKey>& chord_keys, unsigned d
 
 void TestFixture::set_keymap(std::initializer_list<KeymapKey> keys) {
     this->keymap.clear();
+    layer_lookup_cache_invalidate();
     for (auto& key : keys) {
         add_key(key);
     }
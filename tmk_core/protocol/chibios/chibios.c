@@ -48,6 +48,9 @@
 #endif
 #include "suspend.h"
 #include "wait.h"
+#ifdef KEY_EVENT_QUEUE_ENABLE
+#    include "key_event_queue.h"
+#endif
 
 #define USB_GETSTATUS_REMOTE_WAKEUP_ENABLED (2U)
 
@@ -180,6 +183,10 @@ void protocol_pre_task(void) {
 #if !defined(NO_USB_STARTUP_CHECK)
     if (USB_DRIVER.state == USB_SUSPENDED) {
         dprintln("suspending keyboard");
+#    ifdef KEY_EVENT_QUEUE_ENABLE
+        // suspend_wakeup_condition() scans the matrix from here instead
+        key_event_queue_pause();
+#    endif
         while (USB_DRIVER.state == USB_SUSPENDED) {
             /* Do this in the suspended state */
             suspend_power_down(); // on AVR this deep sleeps for 15ms
@@ -197,6 +204,9 @@ void protocol_pre_task(void) {
 #    endif
             }
         }
+#    ifdef KEY_EVENT_QUEUE_ENABLE
+        key_event_queue_resume();
+#    endif
         /* Woken up */
     }
 #endif
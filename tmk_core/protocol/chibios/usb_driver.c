@@ -103,6 +103,9 @@ void usb_endpoint_in_start(usb_endpoint_in_t *endpoint) {
     osalDbgAssert((usbGetDriverStateI(endpoint->config.usbp) == USB_STOP) || (usbGetDriverStateI(endpoint->config.usbp) == USB_READY), "invalid state");
     endpoint->config.usbp->in_params[endpoint->config.ep - 1U] = endpoint;
     endpoint->timed_out                                        = false;
+#if defined(USB_REPORT_SCHEDULER)
+    endpoint->direct_report = NULL;
+#endif
     osalSysUnlock();
 }
 
@@ -146,6 +149,9 @@ void usb_endpoint_out_stop(usb_endpoint_out_t *endpoint) {
 void usb_endpoint_in_suspend_cb(usb_endpoint_in_t *endpoint) {
     bqSuspendI(&endpoint->obqueue);
     obqResetI(&endpoint->obqueue);
+#if defined(USB_REPORT_SCHEDULER)
+    endpoint->direct_report = NULL;
+#endif
 
     if (endpoint->report_storage != NULL) {
         endpoint->report_storage->reset_report(endpoint->report_storage->reports);
@@ -169,6 +175,9 @@ void usb_endpoint_in_configure_cb(usb_endpoint_in_t *endpoint) {
     usbInitEndpointI(endpoint->config.usbp, endpoint->config.ep, &endpoint->ep_config);
     obqResetI(&endpoint->obqueue);
     bqResumeX(&endpoint->obqueue);
+#if defined(USB_REPORT_SCHEDULER)
+    endpoint->direct_report = NULL;
+#endif
 }
 
 void usb_endpoint_out_configure_cb(usb_endpoint_out_t *endpoint) {
@@ -197,8 +206,21 @@ void usb_endpoint_in_tx_complete_cb(USBDriver *usbp, usbep_t ep) {
     /* Sending succeded, so we can reset the timed out state. */
     endpoint->timed_out = false;
 
+    bool direct = false;
+#if defined(USB_REPORT_SCHEDULER)
+    /* The report just transmitted did not come from the queue, so there is
+     * nothing to free. */
+    if (endpoint->direct_report != NULL) {
+        if (endpoint->report_storage != NULL) {
+            endpoint->report_storage->set_report(endpoint->report_storage->reports, endpoint->direct_report, usbp->epc[ep]->in_state->txsize);
+        }
+        endpoint->direct_report = NULL;
+        direct                  = true;
+    }
+#endif
+
     /* Freeing the buffer just transmitted, if it was not a zero size packet.*/
-    if (!obqIsEmptyI(&endpoint->obqueue) && usbp->epc[ep]->in_state->txsize > 0U) {
+    if (!direct && !obqIsEmptyI(&endpoint->obqueue) && usbp->epc[ep]->in_state->txsize > 0U) {
         /* Store the last send report in the endpoint to be retrieved by a
          * GET_REPORT request or IDLE report handling. */
         if (endpoint->report_storage != NULL) {
@@ -320,6 +342,34 @@ bool usb_endpoint_in_is_inactive(usb_endpoint_in_t *endpoint) {
     return inactive;
 }
 
+#if defined(USB_REPORT_SCHEDULER)
+bool usb_endpoint_in_is_inactive_i(usb_endpoint_in_t *endpoint) {
+    osalDbgCheckClassI();
+
+    /* A buffer being filled by a thread is not counted in the queue until it
+     * is posted. */
+    return obqIsEmptyI(&endpoint->obqueue) && endpoint->obqueue.ptr == NULL && !usbGetTransmitStatusI(endpoint->config.usbp, endpoint->config.ep);
+}
+
+/**
+ * @brief Starts sending a report straight from the given buffer, bypassing the
+ * queue, if the endpoint is inactive. The buffer must be left untouched until
+ * the transfer completes, which clears `direct_report`.
+ */
+bool usb_endpoint_in_transmit_direct_i(usb_endpoint_in_t *endpoint, const uint8_t *data, size_t size) {
+    osalDbgCheckClassI();
+    osalDbgCheck((endpoint != NULL) && (data != NULL) && (size > 0U) && (size <= endpoint->config.buffer_size));
+
+    if (usbGetDriverStateI(endpoint->config.usbp) != USB_ACTIVE || !usb_endpoint_in_is_inactive_i(endpoint)) {
+        return false;
+    }
+
+    endpoint->direct_report = data;
+    usbStartTransmitI(endpoint->config.usbp, endpoint->config.ep, data, size);
+    return true;
+}
+#endif
+
 bool usb_endpoint_out_receive(usb_endpoint_out_t *endpoint, uint8_t *data, size_t size, sysinterval_t timeout) {
     osalDbgCheck((endpoint != NULL) && (data != NULL) && (size > 0U));
 
@@ -166,6 +166,12 @@ typedef struct {
     usbreqhandler_t       usb_requests_cb;
     bool                  timed_out;
     usb_report_storage_t *report_storage;
+#if defined(USB_REPORT_SCHEDULER)
+    /**
+     * @brief Report being sent by usb_endpoint_in_transmit_direct_i, NULL if none
+     */
+    const uint8_t *direct_report;
+#endif
 } usb_endpoint_in_t;
 
 typedef struct {
@@ -187,6 +193,10 @@ void usb_endpoint_in_stop(usb_endpoint_in_t *endpoint);
 bool usb_endpoint_in_send(usb_endpoint_in_t *endpoint, const uint8_t *data, size_t size, sysinterval_t timeout, bool buffered);
 void usb_endpoint_in_flush(usb_endpoint_in_t *endpoint, bool padded);
 bool usb_endpoint_in_is_inactive(usb_endpoint_in_t *endpoint);
+#if defined(USB_REPORT_SCHEDULER)
+bool usb_endpoint_in_is_inactive_i(usb_endpoint_in_t *endpoint);
+bool usb_endpoint_in_transmit_direct_i(usb_endpoint_in_t *endpoint, const uint8_t *data, size_t size);
+#endif
 
 void usb_endpoint_in_suspend_cb(usb_endpoint_in_t *endpoint);
 void usb_endpoint_in_wakeup_cb(usb_endpoint_in_t *endpoint);
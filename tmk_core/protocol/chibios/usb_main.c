@@ -62,6 +62,11 @@ static bool __attribute__((__unused__)) send_report_buffered(usb_endpoint_in_lut
 static void __attribute__((__unused__)) flush_report_buffered(usb_endpoint_in_lut_t endpoint, bool padded);
 static bool __attribute__((__unused__)) receive_report(usb_endpoint_out_lut_t endpoint, void *report, size_t size);
 
+#ifdef USB_REPORT_SCHEDULER
+static void usb_report_scheduler_reset_i(void);
+static void usb_report_scheduler_sof_cb(USBDriver *usbp);
+#endif
+
 /* ---------------------------------------------------------
  *            Descriptors and USB driver objects
  * ---------------------------------------------------------
@@ -201,11 +206,20 @@ static void usb_event_cb(USBDriver *usbp, usbevent_t event) {
         case USB_EVENT_UNCONFIGURED:
             /* Falls into.*/
         case USB_EVENT_RESET:
+#ifdef MOUSE_HIRES_SCROLL_ENABLE
+            // Here rather than in the event queue, so as not to undo a multiplier set by the next enumeration
+            if (event == USB_EVENT_RESET) {
+                host_mouse_resolution_multiplier_set(0);
+            }
+#endif
             usb_event_queue_enqueue(event);
             chSysLockFromISR();
             for (int i = 0; i < USB_ENDPOINT_IN_COUNT; i++) {
                 usb_endpoint_in_suspend_cb(&usb_endpoints_in[i]);
             }
+#ifdef USB_REPORT_SCHEDULER
+            usb_report_scheduler_reset_i();
+#endif
             for (int i = 0; i < USB_ENDPOINT_OUT_COUNT; i++) {
                 usb_endpoint_out_suspend_cb(&usb_endpoints_out[i]);
             }
@@ -257,6 +271,22 @@ static void set_led_transfer_cb(USBDriver *usbp) {
     }
 }
 
+#ifdef MOUSE_HIRES_SCROLL_ENABLE
+static uint8_t _Alignas(4) mouse_feature_buf[MOUSE_FEATURE_REPORT_SIZE];
+
+static bool is_mouse_feature_request(usb_control_request_t *setup) {
+    return setup->wIndex == MOUSE_FEATURE_INTERFACE && setup->wValue.hbyte == HID_REPORT_TYPE_FEATURE && setup->wValue.lbyte == MOUSE_FEATURE_REPORT_ID;
+}
+
+static void set_mouse_feature_transfer_cb(USBDriver *usbp) {
+    usb_control_request_t *setup = (usb_control_request_t *)usbp->setup;
+
+    if (setup->wLength == sizeof(mouse_feature_buf)) {
+        host_mouse_resolution_multiplier_set(mouse_feature_buf[sizeof(mouse_feature_buf) - 1]);
+    }
+}
+#endif
+
 static bool usb_requests_hook_cb(USBDriver *usbp) {
     usb_control_request_t *setup = (usb_control_request_t *)usbp->setup;
 
@@ -266,6 +296,15 @@ static bool usb_requests_hook_cb(USBDriver *usbp) {
             case USB_RTYPE_DIR_DEV2HOST:
                 switch (setup->bRequest) {
                     case HID_REQ_GetReport:
+#ifdef MOUSE_HIRES_SCROLL_ENABLE
+                        if (is_mouse_feature_request(setup)) {
+                            // Without a report ID, the multiplier overwrites it
+                            mouse_feature_buf[0]                             = MOUSE_FEATURE_REPORT_ID;
+                            mouse_feature_buf[sizeof(mouse_feature_buf) - 1] = host_mouse_resolution_multiplier();
+                            usbSetupTransfer(usbp, mouse_feature_buf, sizeof(mouse_feature_buf), NULL);
+                            return true;
+                        }
+#endif
                         return usb_get_report_cb(usbp);
                     case HID_REQ_GetProtocol:
                         if (setup->wIndex == KEYBOARD_INTERFACE) {
@@ -281,6 +320,12 @@ static bool usb_requests_hook_cb(USBDriver *usbp) {
             case USB_RTYPE_DIR_HOST2DEV:
                 switch (setup->bRequest) {
                     case HID_REQ_SetReport:
+#ifdef MOUSE_HIRES_SCROLL_ENABLE
+                        if (is_mouse_feature_request(setup)) {
+                            usbSetupTransfer(usbp, mouse_feature_buf, sizeof(mouse_feature_buf), set_mouse_feature_transfer_cb);
+                            return true;
+                        }
+#endif
                         switch (setup->wIndex) {
                             case KEYBOARD_INTERFACE:
 #if defined(SHARED_EP_ENABLE) && !defined(KEYBOARD_SHARED_EP)
@@ -334,7 +379,9 @@ static const USBConfig usbcfg = {
     usb_event_cb,          /* USB events callback */
     usb_get_descriptor_cb, /* Device GET_DESCRIPTOR request callback */
     usb_requests_hook_cb,  /* Requests hook callback */
-#if STM32_USB_USE_OTG1 == TRUE || STM32_USB_USE_OTG2 == TRUE
+#if defined(USB_REPORT_SCHEDULER)
+    usb_report_scheduler_sof_cb, /* Start of frame callback */
+#elif STM32_USB_USE_OTG1 == TRUE || STM32_USB_USE_OTG2 == TRUE
     dummy_cb, /* Workaround for OTG Peripherals not servicing new interrupts
     after resuming from suspend. */
 #endif
@@ -456,18 +503,224 @@ static bool receive_report(usb_endpoint_out_lut_t endpoint, void *report, size_t
     return usb_endpoint_out_receive(&usb_endpoints_out[endpoint], (uint8_t *)report, size, TIME_IMMEDIATE);
 }
 
+/* ---------------------------------------------------------
+ *                    Report scheduler
+ * ---------------------------------------------------------
+ */
+
+#ifdef USB_REPORT_SCHEDULER
+/* A report sent while its endpoint is busy is held back instead of being
+ * queued behind the others. A newer report sent before it goes out replaces
+ * it if the two can be merged without losing anything, e.g. two mouse reports
+ * with the same buttons, so that the host gets the latest state rather than a
+ * queue of stale reports. The held report is handed to the endpoint at the
+ * next start of frame where the endpoint is idle, i.e. just before the host
+ * polls it. */
+
+/* Merges report into held, returns false if that would lose anything */
+typedef bool (*usb_report_merge_t)(void *held, const void *report);
+
+typedef union {
+    report_keyboard_t keyboard;
+#    ifdef NKRO_ENABLE
+    report_nkro_t nkro;
+#    endif
+    report_mouse_t     mouse;
+    report_extra_t     extra;
+    report_digitizer_t digitizer;
+} usb_report_t;
+
+typedef struct {
+    uint8_t _Alignas(4) held[sizeof(usb_report_t)];
+    uint8_t _Alignas(4) sending[sizeof(usb_report_t)];
+    size_t             held_size; // 0 if no report is held
+    usb_report_merge_t merge;
+    bool               queueing; // a previously held report is being queued ahead of this one
+} usb_report_slot_t;
+
+static usb_report_slot_t  usb_report_slots[USB_ENDPOINT_IN_COUNT];
+static usb_report_stats_t usb_report_stats[USB_ENDPOINT_IN_COUNT];
+
+static bool usb_report_commit_i(usb_endpoint_in_lut_t endpoint) {
+    usb_report_slot_t *slot = &usb_report_slots[endpoint];
+
+    // sending may still be in flight while the endpoint is busy
+    if (slot->queueing || !usb_endpoint_in_is_inactive_i(&usb_endpoints_in[endpoint])) {
+        return false;
+    }
+    memcpy(slot->sending, slot->held, slot->held_size);
+    if (!usb_endpoint_in_transmit_direct_i(&usb_endpoints_in[endpoint], slot->sending, slot->held_size)) {
+        return false;
+    }
+    slot->held_size = 0;
+    usb_report_stats[endpoint].sent++;
+    return true;
+}
+
+static void usb_report_scheduler_sof_cb(USBDriver *usbp) {
+    osalSysLockFromISR();
+    for (int i = 0; i < USB_ENDPOINT_IN_COUNT; i++) {
+        if (usb_report_slots[i].held_size > 0) {
+            usb_report_commit_i(i);
+        }
+    }
+    osalSysUnlockFromISR();
+}
+
+static void usb_report_scheduler_reset_i(void) {
+    for (int i = 0; i < USB_ENDPOINT_IN_COUNT; i++) {
+        if (usb_report_slots[i].held_size > 0) {
+            usb_report_slots[i].held_size = 0;
+            usb_report_stats[i].dropped++;
+        }
+    }
+}
+
+/**
+ * @brief Send a report to the host, holding it back while the endpoint is busy
+ * so that it can be merged with newer reports.
+ *
+ * @param endpoint USB IN endpoint to send the report from
+ * @param report pointer to the report
+ * @param size size of the report
+ * @param merge function merging a newer report of the same kind into this
+ * one, or NULL if reports of this kind can never be merged
+ * @return true Success
+ * @return false Failure
+ */
+static bool send_report_scheduled(usb_endpoint_in_lut_t endpoint, void *report, size_t size, usb_report_merge_t merge) {
+    usb_report_slot_t *slot = &usb_report_slots[endpoint];
+    uint8_t _Alignas(4) queued[sizeof(usb_report_t)];
+    size_t             queued_size = 0;
+
+    osalSysLock();
+    if (slot->held_size == 0 && usb_endpoint_in_is_inactive_i(&usb_endpoints_in[endpoint])) {
+        // Nothing to wait for
+        usb_report_stats[endpoint].sent++;
+        osalSysUnlock();
+        return send_report(endpoint, report, size);
+    }
+
+    if (slot->held_size == size && memcmp(slot->held, report, size) == 0) {
+        usb_report_stats[endpoint].dropped++;
+    } else if (slot->held_size == size && slot->merge == merge && merge != NULL && merge(slot->held, report)) {
+        usb_report_stats[endpoint].coalesced++;
+    } else {
+        // The held report cannot be replaced, so it is queued ahead of this one
+        if (slot->held_size > 0) {
+            memcpy(queued, slot->held, slot->held_size);
+            queued_size    = slot->held_size;
+            slot->queueing = true;
+            usb_report_stats[endpoint].sent++;
+        }
+        memcpy(slot->held, report, size);
+        slot->held_size = size;
+        slot->merge     = merge;
+    }
+    osalSysUnlock();
+
+    if (queued_size == 0) {
+        return true;
+    }
+    bool sent = send_report(endpoint, queued, queued_size);
+    osalSysLock();
+    slot->queueing = false;
+    osalSysUnlock();
+    return sent;
+}
+
+usb_report_stats_t usb_report_scheduler_get_stats(usb_endpoint_in_lut_t endpoint) {
+    osalSysLock();
+    usb_report_stats_t stats = usb_report_stats[endpoint];
+    osalSysUnlock();
+    return stats;
+}
+
+#    ifdef MOUSE_ENABLE
+#        ifdef MOUSE_EXTENDED_REPORT
+static int8_t usb_report_clamp_boot_xy(int32_t value) {
+    return value > 127 ? 127 : value < -127 ? -127 : value;
+}
+#        endif
+
+static bool usb_report_merge_mouse(void *held, const void *report) {
+    report_mouse_t *      a = held;
+    const report_mouse_t *b = report;
+
+    if (a->buttons != b->buttons) {
+        return false;
+    }
+
+    int32_t x = a->x + b->x;
+    int32_t y = a->y + b->y;
+    int32_t v = a->v + b->v;
+    int32_t h = a->h + b->h;
+#        ifdef MOUSE_EXTENDED_REPORT
+    if (x < INT16_MIN || x > INT16_MAX || y < INT16_MIN || y > INT16_MAX) {
+#        else
+    if (x < INT8_MIN || x > INT8_MAX || y < INT8_MIN || y > INT8_MAX) {
+#        endif
+        return false;
+    }
+#        ifdef WHEEL_EXTENDED_REPORT
+    if (v < INT16_MIN || v > INT16_MAX || h < INT16_MIN || h > INT16_MAX) {
+#        else
+    if (v < INT8_MIN || v > INT8_MAX || h < INT8_MIN || h > INT8_MAX) {
+#        endif
+        return false;
+    }
+
+    a->x = x;
+    a->y = y;
+    a->v = v;
+    a->h = h;
+#        ifdef MOUSE_EXTENDED_REPORT
+    a->boot_x = usb_report_clamp_boot_xy(x);
+    a->boot_y = usb_report_clamp_boot_xy(y);
+#        endif
+    return true;
+}
+#    endif
+
+#    ifdef DIGITIZER_ENABLE
+// Digitizer reports are absolute, so only the position of the held one is out of date
+static bool usb_report_merge_digitizer(void *held, const void *report) {
+    report_digitizer_t *      a = held;
+    const report_digitizer_t *b = report;
+
+    if (a->in_range != b->in_range || a->tip != b->tip || a->barrel != b->barrel) {
+        return false;
+    }
+
+    a->x = b->x;
+    a->y = b->y;
+    return true;
+}
+#    endif
+
+#    define send_report_keyboard(endpoint, report, size) send_report_scheduled(endpoint, report, size, NULL)
+#    define send_report_mouse(endpoint, report, size) send_report_scheduled(endpoint, report, size, usb_report_merge_mouse)
+#    define send_report_extra(endpoint, report, size) send_report_scheduled(endpoint, report, size, NULL)
+#    define send_report_digitizer(endpoint, report, size) send_report_scheduled(endpoint, report, size, usb_report_merge_digitizer)
+#else
+#    define send_report_keyboard send_report
+#    define send_report_mouse send_report
+#    define send_report_extra send_report
+#    define send_report_digitizer send_report
+#endif // USB_REPORT_SCHEDULER
+
 void send_keyboard(report_keyboard_t *report) {
     /* If we're in Boot Protocol, don't send any report ID or other funky fields */
     if (!keyboard_protocol) {
-        send_report(USB_ENDPOINT_IN_KEYBOARD, &report->mods, 8);
+        send_report_keyboard(USB_ENDPOINT_IN_KEYBOARD, &report->mods, 8);
     } else {
-        send_report(USB_ENDPOINT_IN_KEYBOARD, report, KEYBOARD_REPORT_SIZE);
+        send_report_keyboard(USB_ENDPOINT_IN_KEYBOARD, report, KEYBOARD_REPORT_SIZE);
     }
 }
 
 void send_nkro(report_nkro_t *report) {
 #ifdef NKRO_ENABLE
-    send_report(USB_ENDPOINT_IN_SHARED, report, sizeof(report_nkro_t));
+    send_report_keyboard(USB_ENDPOINT_IN_SHARED, report, sizeof(report_nkro_t));
 #endif
 }
 
@@ -478,7 +731,7 @@ void send_nkro(report_nkro_t *report) {
 
 void send_mouse(report_mouse_t *report) {
 #ifdef MOUSE_ENABLE
-    send_report(USB_ENDPOINT_IN_MOUSE, report, sizeof(report_mouse_t));
+    send_report_mouse(USB_ENDPOINT_IN_MOUSE, report, sizeof(report_mouse_t));
 #endif
 }
 
@@ -489,7 +742,7 @@ void send_mouse(report_mouse_t *report) {
 
 void send_extra(report_extra_t *report) {
 #ifdef EXTRAKEY_ENABLE
-    send_report(USB_ENDPOINT_IN_SHARED, report, sizeof(report_extra_t));
+    send_report_extra(USB_ENDPOINT_IN_SHARED, report, sizeof(report_extra_t));
 #endif
 }
 
@@ -507,7 +760,7 @@ void send_joystick(report_joystick_t *report) {
 
 void send_digitizer(report_digitizer_t *report) {
 #ifdef DIGITIZER_ENABLE
-    send_report(USB_ENDPOINT_IN_DIGITIZER, report, sizeof(report_digitizer_t));
+    send_report_digitizer(USB_ENDPOINT_IN_DIGITIZER, report, sizeof(report_digitizer_t));
 #endif
 }
 
@@ -34,6 +34,24 @@ void restart_usb_driver(USBDriver *usbp);
 
 bool send_report(usb_endpoint_in_lut_t endpoint, void *report, size_t size);
 
+/* ----------------
+ * Report scheduler
+ * ----------------
+ */
+
+#ifdef USB_REPORT_SCHEDULER
+
+typedef struct {
+    uint32_t sent;      // Reports handed to the endpoint
+    uint32_t coalesced; // Reports merged into a held report
+    uint32_t dropped;   // Reports discarded, as duplicates of the held report or on suspend or reset
+} usb_report_stats_t;
+
+/* Get the report counters of an endpoint */
+usb_report_stats_t usb_report_scheduler_get_stats(usb_endpoint_in_lut_t endpoint);
+
+#endif
+
 /* ---------------
  * USB Event queue
  * ---------------
@@ -43,6 +43,9 @@ extern keymap_config_t keymap_config;
 static host_driver_t *driver;
 static uint16_t       last_system_usage   = 0;
 static uint16_t       last_consumer_usage = 0;
+#ifdef MOUSE_HIRES_SCROLL_ENABLE
+static uint8_t mouse_resolution_multiplier = 0;
+#endif
 
 void host_set_driver(host_driver_t *d) {
     driver = d;
@@ -129,6 +132,22 @@ void host_mouse_send(report_mouse_t *report) {
     (*driver->send_mouse)(report);
 }
 
+#ifdef MOUSE_HIRES_SCROLL_ENABLE
+/* Called by the USB driver when the host sets or resets the mouse feature
+ * report, which holds the Resolution Multiplier of both wheels */
+void host_mouse_resolution_multiplier_set(uint8_t multiplier) {
+    mouse_resolution_multiplier = multiplier;
+}
+
+uint8_t host_mouse_resolution_multiplier(void) {
+#    ifdef BLUETOOTH_ENABLE
+    // Bluetooth mouse reports do not have a Resolution Multiplier
+    if (where_to_send() == OUTPUT_BLUETOOTH) return 0;
+#    endif
+    return mouse_resolution_multiplier;
+}
+#endif
+
 void host_system_send(uint16_t usage) {
     if (usage == last_system_usage) return;
     last_system_usage = usage;
@@ -47,6 +47,19 @@ void    host_programmable_button_send(uint32_t data);
 uint16_t host_last_system_usage(void);
 uint16_t host_last_consumer_usage(void);
 
+#ifdef MOUSE_HIRES_SCROLL_ENABLE
+void    host_mouse_resolution_multiplier_set(uint8_t multiplier);
+uint8_t host_mouse_resolution_multiplier(void);
+
+/* Wheel movement of a whole detent, which is MOUSE_HIRES_SCROLL_MULTIPLIER
+ * once the host has enabled the Resolution Multiplier of that wheel */
+#    define MOUSE_WHEEL_DETENT_V ((host_mouse_resolution_multiplier() & MOUSE_RESOLUTION_MULTIPLIER_V) ? MOUSE_HIRES_SCROLL_MULTIPLIER : 1)
+#    define MOUSE_WHEEL_DETENT_H ((host_mouse_resolution_multiplier() & MOUSE_RESOLUTION_MULTIPLIER_H) ? MOUSE_HIRES_SCROLL_MULTIPLIER : 1)
+#else
+#    define MOUSE_WHEEL_DETENT_V 1
+#    define MOUSE_WHEEL_DETENT_H 1
+#endif
+
 #ifdef __cplusplus
 }
 #endif
@@ -271,6 +271,9 @@ void EVENT_USB_Device_Disconnect(void) {
 void EVENT_USB_Device_Reset(void) {
     print("[R]");
     usb_device_state_set_reset();
+#ifdef MOUSE_HIRES_SCROLL_ENABLE
+    host_mouse_resolution_multiplier_set(0);
+#endif
 }
 
 /** \brief Event USB Device Connect
@@ -406,6 +409,12 @@ Boot Keyboard   Required    Optional    Required    Required    Required    Requ
 Non-Boot Keybrd Required    Optional    Required    Required    Optional    Optional
 Other Device    Required    Optional    Optional    Optional    Optional    Optional
 */
+#ifdef MOUSE_HIRES_SCROLL_ENABLE
+static uint8_t mouse_feature_report[MOUSE_FEATURE_REPORT_SIZE];
+
+#    define IS_MOUSE_FEATURE_REQUEST() (USB_ControlRequest.wIndex == MOUSE_FEATURE_INTERFACE && USB_ControlRequest.wValue == (HID_REPORT_TYPE_FEATURE << 8 | MOUSE_FEATURE_REPORT_ID))
+#endif
+
 /** \brief Event handler for the USB_ControlRequest event.
  *
  *  This is fired before passing along unhandled control requests to the library for processing internally.
@@ -428,6 +437,15 @@ void EVENT_USB_Device_ControlRequest(void) {
                         ReportSize = sizeof(keyboard_report_sent);
                         break;
                 }
+#ifdef MOUSE_HIRES_SCROLL_ENABLE
+                if (IS_MOUSE_FEATURE_REQUEST()) {
+                    // Without a report ID, the multiplier overwrites it
+                    mouse_feature_report[0]                                = MOUSE_FEATURE_REPORT_ID;
+                    mouse_feature_report[sizeof(mouse_feature_report) - 1] = host_mouse_resolution_multiplier();
+                    ReportData                                             = mouse_feature_report;
+                    ReportSize                                             = sizeof(mouse_feature_report);
+                }
+#endif
 
                 /* Write the report data to the control endpoint */
                 Endpoint_Write_Control_Stream_LE(ReportData, ReportSize);
@@ -437,6 +455,26 @@ void EVENT_USB_Device_ControlRequest(void) {
             break;
         case HID_REQ_SetReport:
             if (USB_ControlRequest.bmRequestType == (REQDIR_HOSTTODEVICE | REQTYPE_CLASS | REQREC_INTERFACE)) {
+#ifdef MOUSE_HIRES_SCROLL_ENABLE
+                if (IS_MOUSE_FEATURE_REQUEST()) {
+                    Endpoint_ClearSETUP();
+
+                    while (!(Endpoint_IsOUTReceived())) {
+                        if (USB_DeviceState == DEVICE_STATE_Unattached) return;
+                    }
+
+                    if (Endpoint_BytesInEndpoint() == sizeof(mouse_feature_report)) {
+#    ifdef MOUSE_SHARED_EP
+                        Endpoint_Discard_8(); // report ID
+#    endif
+                        host_mouse_resolution_multiplier_set(Endpoint_Read_8());
+                    }
+
+                    Endpoint_ClearOUT();
+                    Endpoint_ClearStatusStage();
+                    break;
+                }
+#endif
                 // Interface
                 switch (USB_ControlRequest.wIndex) {
                     case KEYBOARD_INTERFACE:
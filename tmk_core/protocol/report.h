@@ -44,6 +44,13 @@ enum hid_report_ids {
 
 #define IS_VALID_REPORT_ID(id) ((id) >= REPORT_ID_ALL && (id) <= REPORT_ID_COUNT)
 
+/* HID report types, in the high byte of wValue of GET_REPORT and SET_REPORT requests */
+enum hid_report_types {
+    HID_REPORT_TYPE_INPUT = 1,
+    HID_REPORT_TYPE_OUTPUT,
+    HID_REPORT_TYPE_FEATURE
+};
+
 /* Mouse buttons */
 #define MOUSE_BTN_MASK(n) (1 << (n))
 enum mouse_buttons {
@@ -199,6 +206,28 @@ typedef int16_t mouse_xy_report_t;
 typedef int8_t mouse_xy_report_t;
 #endif
 
+#ifdef MOUSE_HIRES_SCROLL_ENABLE
+#    ifndef MOUSE_HIRES_SCROLL_MULTIPLIER
+#        define MOUSE_HIRES_SCROLL_MULTIPLIER 120
+#    endif
+#    if MOUSE_HIRES_SCROLL_MULTIPLIER < 1 || MOUSE_HIRES_SCROLL_MULTIPLIER > 255
+#        error "MOUSE_HIRES_SCROLL_MULTIPLIER must be between 1 and 255"
+#    endif
+#    ifndef WHEEL_EXTENDED_REPORT
+#        define WHEEL_EXTENDED_REPORT
+#    endif
+/* The mouse feature report holds the Resolution Multiplier of each wheel,
+ * which the host sets to 1 to receive the wheel in fractions of a detent */
+#    define MOUSE_RESOLUTION_MULTIPLIER_V 0x03
+#    define MOUSE_RESOLUTION_MULTIPLIER_H 0x0C
+#endif
+
+#ifdef WHEEL_EXTENDED_REPORT
+typedef int16_t mouse_hv_report_t;
+#else
+typedef int8_t mouse_hv_report_t;
+#endif
+
 typedef struct {
 #ifdef MOUSE_SHARED_EP
     uint8_t report_id;
@@ -210,8 +239,8 @@ typedef struct {
 #endif
     mouse_xy_report_t x;
     mouse_xy_report_t y;
-    int8_t            v;
-    int8_t            h;
+    mouse_hv_report_t v;
+    mouse_hv_report_t h;
 } PACKED report_mouse_t;
 
 typedef struct {
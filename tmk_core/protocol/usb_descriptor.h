@@ -198,6 +198,20 @@ enum usb_interfaces {
 
 #define IS_VALID_INTERFACE(i) ((i) >= 0 && (i) < TOTAL_INTERFACES)
 
+#ifdef MOUSE_HIRES_SCROLL_ENABLE
+/* The mouse feature report, holding the Resolution Multiplier of both wheels,
+ * is prefixed with the mouse report ID on the shared interface */
+#    ifdef MOUSE_SHARED_EP
+#        define MOUSE_FEATURE_INTERFACE SHARED_INTERFACE
+#        define MOUSE_FEATURE_REPORT_ID REPORT_ID_MOUSE
+#        define MOUSE_FEATURE_REPORT_SIZE 2
+#    else
+#        define MOUSE_FEATURE_INTERFACE MOUSE_INTERFACE
+#        define MOUSE_FEATURE_REPORT_ID 0
+#        define MOUSE_FEATURE_REPORT_SIZE 1
+#    endif
+#endif
+
 #define NEXT_EPNUM __COUNTER__
 
 /*
@@ -287,9 +287,17 @@ void send_programmable_button(report_programmable_button_t *report) {
  *------------------------------------------------------------------*/
 static struct {
     uint16_t len;
-    enum { NONE, SET_LED } kind;
+    enum { NONE, SET_LED, SET_MOUSE_FEATURE } kind;
 } last_req;
 
+#ifdef MOUSE_HIRES_SCROLL_ENABLE
+// The mouse feature report, holding the Resolution Multiplier of both wheels
+static uint8_t mouse_feature_report[2] = {REPORT_ID_MOUSE};
+
+// Report Type: 0x03(Feature)/ReportID: mouse && Interface: shared
+#    define IS_MOUSE_FEATURE_REQUEST(rq) ((rq)->wValue.word == (HID_REPORT_TYPE_FEATURE << 8 | REPORT_ID_MOUSE) && (rq)->wIndex.word == SHARED_INTERFACE)
+#endif
+
 usbMsgLen_t usbFunctionSetup(uchar data[8]) {
     usbRequest_t *rq = (void *)data;
 
@@ -301,6 +309,13 @@ usbMsgLen_t usbFunctionSetup(uchar data[8]) {
                     usbMsgPtr = (usbMsgPtr_t)&keyboard_report_sent;
                     return sizeof(keyboard_report_sent);
                 }
+#ifdef MOUSE_HIRES_SCROLL_ENABLE
+                if (IS_MOUSE_FEATURE_REQUEST(rq)) {
+                    mouse_feature_report[1] = host_mouse_resolution_multiplier();
+                    usbMsgPtr               = (usbMsgPtr_t)mouse_feature_report;
+                    return sizeof(mouse_feature_report);
+                }
+#endif
                 break;
             case USBRQ_HID_GET_IDLE:
                 dprint("GET_IDLE:");
@@ -318,6 +333,13 @@ usbMsgLen_t usbFunctionSetup(uchar data[8]) {
                     last_req.kind = SET_LED;
                     last_req.len  = rq->wLength.word;
                 }
+#ifdef MOUSE_HIRES_SCROLL_ENABLE
+                if (IS_MOUSE_FEATURE_REQUEST(rq)) {
+                    dprint("SET_MOUSE_FEATURE:");
+                    last_req.kind = SET_MOUSE_FEATURE;
+                    last_req.len  = rq->wLength.word;
+                }
+#endif
                 return USB_NO_MSG; // to get data in usbFunctionWrite
             case USBRQ_HID_SET_IDLE:
                 keyboard_idle = (rq->wValue.word & 0xFF00) >> 8;
@@ -352,6 +374,17 @@ uchar usbFunctionWrite(uchar *data, uchar len) {
             last_req.len       = 0;
             return 1;
             break;
+#ifdef MOUSE_HIRES_SCROLL_ENABLE
+        case SET_MOUSE_FEATURE:
+            // data[0] is the report ID
+            if (len == sizeof(mouse_feature_report)) {
+                dprintf("SET_MOUSE_FEATURE: %02X\n", data[1]);
+                host_mouse_resolution_multiplier_set(data[1]);
+            }
+            last_req.len = 0;
+            return 1;
+            break;
+#endif
         case NONE:
         default:
             return -1;
@@ -524,21 +557,70 @@ const PROGMEM uchar shared_hid_report[] = {
 #    endif
     0x81, 0x06, //     Input (Data, Variable, Relative)
 
-    // Vertical wheel (1 byte)
+#    ifdef MOUSE_HIRES_SCROLL_ENABLE
+    0xA1, 0x02, //     Collection (Logical)
+    // Resolution Multiplier (2 bits)
+    0x09, 0x48,                                                            //       Usage (Resolution Multiplier)
+    0x15, 0x00,                                                            //       Logical Minimum (0)
+    0x25, 0x01,                                                            //       Logical Maximum (1)
+    0x35, 0x01,                                                            //       Physical Minimum (1)
+    0x46, MOUSE_HIRES_SCROLL_MULTIPLIER & 0xFF, MOUSE_HIRES_SCROLL_MULTIPLIER >> 8, //       Physical Maximum (MOUSE_HIRES_SCROLL_MULTIPLIER)
+    0x95, 0x01,                                                            //       Report Count (1)
+    0x75, 0x02,                                                            //       Report Size (2)
+    0xB1, 0x02,                                                            //       Feature (Data, Variable, Absolute)
+    0x35, 0x00,                                                            //       Physical Minimum (0)
+    0x45, 0x00,                                                            //       Physical Maximum (0)
+#    endif
+    // Vertical wheel (1 or 2 bytes)
     0x09, 0x38, //     Usage (Wheel)
+#    ifndef WHEEL_EXTENDED_REPORT
     0x15, 0x81, //     Logical Minimum (-127)
     0x25, 0x7F, //     Logical Maximum (127)
     0x95, 0x01, //     Report Count (1)
     0x75, 0x08, //     Report Size (8)
+#    else
+    0x16, 0x01, 0x80, // Logical Minimum (-32767)
+    0x26, 0xFF, 0x7F, // Logical Maximum (32767)
+    0x95, 0x01,       // Report Count (1)
+    0x75, 0x10,       // Report Size (16)
+#    endif
     0x81, 0x06, //     Input (Data, Variable, Relative)
-    // Horizontal wheel (1 byte)
+#    ifdef MOUSE_HIRES_SCROLL_ENABLE
+    0xC0,       //     End Collection
+    0xA1, 0x02, //     Collection (Logical)
+    // Resolution Multiplier (2 bits)
+    0x09, 0x48,                                                            //       Usage (Resolution Multiplier)
+    0x15, 0x00,                                                            //       Logical Minimum (0)
+    0x25, 0x01,                                                            //       Logical Maximum (1)
+    0x35, 0x01,                                                            //       Physical Minimum (1)
+    0x46, MOUSE_HIRES_SCROLL_MULTIPLIER & 0xFF, MOUSE_HIRES_SCROLL_MULTIPLIER >> 8, //       Physical Maximum (MOUSE_HIRES_SCROLL_MULTIPLIER)
+    0x95, 0x01,                                                            //       Report Count (1)
+    0x75, 0x02,                                                            //       Report Size (2)
+    0xB1, 0x02,                                                            //       Feature (Data, Variable, Absolute)
+    0x35, 0x00,                                                            //       Physical Minimum (0)
+    0x45, 0x00,                                                            //       Physical Maximum (0)
+    // Feature padding (4 bits)
+    0x75, 0x04, //       Report Size (4)
+    0xB1, 0x03, //       Feature (Constant)
+#    endif
+    // Horizontal wheel (1 or 2 bytes)
     0x05, 0x0C,       //     Usage Page (Consumer)
     0x0A, 0x38, 0x02, //     Usage (AC Pan)
+#    ifndef WHEEL_EXTENDED_REPORT
     0x15, 0x81,       //     Logical Minimum (-127)
     0x25, 0x7F,       //     Logical Maximum (127)
     0x95, 0x01,       //     Report Count (1)
     0x75, 0x08,       //     Report Size (8)
+#    else
+    0x16, 0x01, 0x80, //     Logical Minimum (-32767)
+    0x26, 0xFF, 0x7F, //     Logical Maximum (32767)
+    0x95, 0x01,       //     Report Count (1)
+    0x75, 0x10,       //     Report Size (16)
+#    endif
     0x81, 0x06,       //     Input (Data, Variable, Relative)
+#    ifdef MOUSE_HIRES_SCROLL_ENABLE
+    0xC0, //     End Collection
+#    endif
     0xC0,             //   End Collection
     0xC0,             // End Collection
 #endif